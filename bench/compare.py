@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+        compare.py
+    Compares two sets of results written by bench/run.py.
+
+    Prints the ratio of each program's compile time, compiler peak RSS, and
+    runtime to those of the baseline.  Exits with a nonzero status if any
+    measurement regressed by more than the given threshold so it can be
+    used in CI.
+
+    usage: bench/compare.py baseline.json results.json [--threshold 10] [--phases]
+"""
+import argparse
+import json
+import sys
+
+#Times below this many seconds are too noisy to report a regression on
+MIN_TIME = 0.01
+
+
+def ratio(old, new):
+    return new / old if old else float('inf') if new else 1.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two ante benchmark results')
+    parser.add_argument('baseline')
+    parser.add_argument('results')
+    parser.add_argument('--threshold', type=float, default=10,
+                        help='percent increase considered a regression')
+    parser.add_argument('--phases', action='store_true', help='also compare the time of each compile phase')
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        base = json.load(f)
+    with open(args.results) as f:
+        new = json.load(f)
+
+    print('baseline %s (%s), results %s (%s)\n' % (base.get('commit'), base.get('date'),
+          new.get('commit'), new.get('date')))
+    print('%-36s %10s %10s %10s' % ('program', 'compile', 'rss', 'run'))
+
+    limit = 1 + args.threshold / 100
+    regressions = []
+
+    def compare(name, what, old, new, minimum):
+        r = ratio(old, new)
+        if r > limit and max(old, new) >= minimum:
+            regressions.append('%s %s: %.3f -> %.3f (%+.1f%%)' % (name, what, old, new, (r - 1) * 100))
+        return '%9.3fx' % r
+
+    for name in sorted(set(base['results']) & set(new['results'])):
+        b = base['results'][name]
+        n = new['results'][name]
+        cols = []
+
+        bc, nc = b['compile'], n['compile']
+        if bc['status'] == 0 and nc['status'] != 0:
+            regressions.append('%s no longer compiles' % name)
+
+        cols.append(compare(name, 'compile time', bc['wall'], nc['wall'], MIN_TIME))
+        cols.append(compare(name, 'compiler rss', bc.get('maxrss_kb', 0), nc.get('maxrss_kb', 0), 0))
+
+        if 'run' in b and 'run' in n:
+            cols.append(compare(name, 'runtime', b['run']['wall'], n['run']['wall'], MIN_TIME))
+        else:
+            cols.append('%10s' % '-')
+
+        print('%-36s %s' % (name, ' '.join(cols)))
+
+        if args.phases:
+            for phase in sorted(set(bc['phases']) | set(nc['phases'])):
+                old, cur = bc['phases'].get(phase, 0.0), nc['phases'].get(phase, 0.0)
+                print('    %-32s %9.4fs -> %9.4fs  %s' % (phase, old, cur,
+                      compare(name, phase, old, cur, MIN_TIME)))
+
+    for name in sorted(set(base['results']) - set(new['results'])):
+        print('%-36s missing from results' % name)
+
+    if regressions:
+        print('\n%d regression(s) above %g%%:' % (len(regressions), args.threshold))
+        for r in regressions:
+            print('  ' + r)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
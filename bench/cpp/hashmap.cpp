@@ -0,0 +1,32 @@
+/*
+ *      hashmap.cpp
+ * Baseline for bench/programs/hashmap.an using std::unordered_map.
+ */
+#include <cstdio>
+#include <ctime>
+#include <unordered_map>
+
+int main(){
+    const int n = 1000000;
+    std::unordered_map<int,int> m;
+
+    clock_t t0 = clock();
+    for(int i = 0; i < n; i++)
+        m[i * 7] = i;
+
+    clock_t t1 = clock();
+    int found = 0;
+    for(int i = 0; i < n * 7; i++)
+        if(m.count(i)) found++;
+
+    clock_t t2 = clock();
+    long sum = 0;
+    for(auto &kv : m)
+        sum += kv.second;
+
+    clock_t t3 = clock();
+    printf("insert %ldms, lookup %ldms, iterate %ldms (found %d, sum %ld)\n",
+            (long)(t1 - t0) * 1000 / CLOCKS_PER_SEC, (long)(t2 - t1) * 1000 / CLOCKS_PER_SEC,
+            (long)(t3 - t2) * 1000 / CLOCKS_PER_SEC, found, sum);
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ *      vec_sum.cpp
+ * Baseline for bench/programs/vec_sum.an using std::vector.
+ */
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+int main(){
+    const int n = 10000000;
+    std::vector<int> v;
+    v.reserve(n);
+
+    for(int i = 0; i < n; i++)
+        v.push_back(i % 1000);
+
+    clock_t t0 = clock();
+    long sum = 0;
+    for(int rep = 0; rep < 50; rep++)
+        for(int x : v)
+            sum += x;
+
+    clock_t t1 = clock();
+    printf("sum %ldms (sum %ld)\n", (long)(t1 - t0) * 1000 / CLOCKS_PER_SEC, sum);
+    return 0;
+}
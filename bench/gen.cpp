@@ -0,0 +1,345 @@
+/*
+ *      gen.cpp
+ * Generates synthetic Ante programs of a given size for scaling tests
+ * of the compiler.  Build with 'make angen' and see 'make scaling'.
+ * With -bench it instead writes the fixed set of compile-time benchmark
+ * programs that 'make bench' runs along with bench/programs.
+ *
+ * Each parameter scales a separate part of the program so superlinear
+ * compile times can be traced back to the feature that triggers them.
+ */
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct GenArgs {
+    unsigned int functions = 100;
+    unsigned int overloads = 1;
+    unsigned int genericDepth = 0;
+    unsigned int matchArms = 0;
+    unsigned int imports = 0;
+    unsigned int interpolations = 0;
+    string outDir = "";
+};
+
+
+void printHelp(){
+    puts("Generates a synthetic Ante program for scaling tests\n");
+    puts("Usage: angen [options] -o <dir>");
+    puts("       angen -bench <dir>");
+    puts("Writes <dir>/main.an and any imported modules to <dir>,");
+    puts("or with -bench the compile-time benchmark programs\n");
+    puts("options:");
+    puts("\t-functions <n>\tnumber of function names (default 100)");
+    puts("\t-overloads <n>\toverloads of each function name, each on a different type (default 1)");
+    puts("\t-generics <n>\tdepth of nested generic types instantiated (default 0)");
+    puts("\t-match <n>\tnumber of arms in a match over a union type (default 0)");
+    puts("\t-imports <n>\tlength of a chain of imported modules (default 0)");
+    puts("\t-interpolations <n>\tnumber of interpolated strings (default 0)");
+}
+
+
+/*
+ *  Functions f0 through f{n-1}, each with one overload per type.  Each function
+ *  calls the function at half its index so on-demand compilation nests log n deep.
+ */
+void genFunctions(ofstream &out, GenArgs &args){
+    if(args.overloads > 1){
+        for(unsigned int t = 0; t < args.overloads; t++)
+            out << "type T" << t << " = i32 v\n";
+        out << "\n";
+    }
+
+    for(unsigned int i = 0; i < args.functions; i++){
+        for(unsigned int t = 0; t < args.overloads; t++){
+            bool typed = args.overloads > 1;
+            string param = typed ? "T" + to_string(t) : "i32";
+            string x = typed ? "x.v" : "x";
+
+            out << "fun f" << i << ": " << param << " x -> i32\n";
+            out << "    let y = " << x << " * " << (i % 13 + 1) << " + " << t << "\n";
+            if(i > 0)
+                out << "    y + f" << i / 2 << " " << (typed ? "(" + param + " (y % 7))" : "(y % 7)") << "\n\n";
+            else
+                out << "    y\n\n";
+        }
+    }
+}
+
+void genFunctionCalls(ofstream &out, GenArgs &args){
+    out << "var sum = 0\n";
+    for(unsigned int i = 0; i < args.functions; i++){
+        for(unsigned int t = 0; t < args.overloads; t++){
+            if(args.overloads > 1)
+                out << "sum += f" << i << " (T" << t << " " << i << ")\n";
+            else
+                out << "sum += f" << i << " " << i << "\n";
+        }
+    }
+    out << "printf \"sum = %d\\n\" sum\n\n";
+}
+
+
+/*
+ *  A generic type nested k deep, e.g. Box (Box (Box i32)), with a generic
+ *  function instantiated once for each level of nesting
+ */
+void genGenerics(ofstream &out, GenArgs &args){
+    out << "type Box 't = 't val\n\n";
+    out << "fun unbox: Box 't b -> 't\n    b.val\n\n";
+    out << "fun wrap: 't x -> Box 't\n    Box x\n\n";
+}
+
+void genGenericCalls(ofstream &out, GenArgs &args){
+    out << "let b0 = 1\n";
+    for(unsigned int i = 1; i <= args.genericDepth; i++)
+        out << "let b" << i << " = wrap b" << i - 1 << "\n";
+
+    string expr = "b" + to_string(args.genericDepth);
+    for(unsigned int i = 0; i < args.genericDepth; i++)
+        expr = "(unbox " + expr + ")";
+
+    out << "printf \"unboxed = %d\\n\" " << expr << "\n\n";
+}
+
+
+void genMatch(ofstream &out, GenArgs &args){
+    out << "type Arm =";
+    for(unsigned int i = 0; i < args.matchArms; i++)
+        out << (i % 8 == 0 ? "\n    " : " ") << "| A" << i;
+    out << "\n\n";
+
+    out << "fun to_arm: i32 i -> Arm\n";
+    for(unsigned int i = 0; i + 1 < args.matchArms; i++)
+        out << "    " << (i == 0 ? "if" : "elif") << " i == " << i << " then A" << i << "\n";
+    out << "    " << (args.matchArms > 1 ? "else " : "") << "A" << args.matchArms - 1 << "\n\n";
+
+    out << "fun eval_arm: Arm a -> i32\n";
+    out << "    match a with\n";
+    for(unsigned int i = 0; i < args.matchArms; i++)
+        out << "    | A" << i << " -> " << i * 3 + 1 << "\n";
+    out << "\n";
+}
+
+void genMatchCalls(ofstream &out, GenArgs &args){
+    out << "var arms = 0\nvar i = 0\n";
+    out << "while i < " << args.matchArms << " do\n";
+    out << "    arms += eval_arm (to_arm i)\n";
+    out << "    i += 1\n\n";
+    out << "printf \"arms = %d\\n\" arms\n\n";
+}
+
+
+/*
+ *  A chain of modules where mod{i} imports mod{i+1} and
+ *  calls the function it defines
+ */
+bool genImports(GenArgs &args){
+    for(unsigned int i = 0; i < args.imports; i++){
+        string path = args.outDir + "/mod" + to_string(i) + ".an";
+        ofstream mod{path};
+        if(!mod){
+            cerr << "Could not open " << path << " for writing\n";
+            return false;
+        }
+
+        mod << "//Generated by angen\n";
+        if(i + 1 < args.imports)
+            mod << "import \"" << args.outDir << "/mod" << i + 1 << ".an\"\n";
+
+        mod << "\nfun g" << i << ": i32 x -> i32\n";
+        mod << "    " << (i + 1 < args.imports ? "g" + to_string(i + 1) + " (x + 1)" : "x") << "\n";
+    }
+    return true;
+}
+
+void genImportCalls(ofstream &out, GenArgs &args){
+    out << "printf \"imports = %d\\n\" (g0 0)\n\n";
+}
+
+
+void genInterpolations(ofstream &out, GenArgs &args){
+    out << "let name = \"ante\"\n";
+    for(unsigned int i = 0; i < args.interpolations; i++)
+        out << "let s" << i << " = \"${name} string " << i << " is ${name}${name}\"\n";
+
+    out << "var len = 0usz\n";
+    for(unsigned int i = 0; i < args.interpolations; i++)
+        out << "len += s" << i << ".len\n";
+    out << "printf \"len = %lu\\n\" len\n\n";
+}
+
+
+/*
+ *  Compile-time benchmarks.  Each is the same on every run so their
+ *  results can be compared across commits by bench/compare.py.
+ */
+
+//Several thousand lines of straight-line code in a single function
+void genLongFile(ofstream &out){
+    out << "var acc = 0\n";
+    for(unsigned int i = 0; i < 1000; i++){
+        out << "let x" << i << " = " << i << " * 3 + acc % 7\n";
+        out << "acc += x" << i << "\n";
+        out << "if acc > 100000 then acc -= 100000\n";
+    }
+    out << "printf \"%d\\n\" acc\n";
+}
+
+//A chain of functions, each compiled on demand while compiling its caller
+void genManyFunctions(ofstream &out){
+    out << "fun f0: i32 x -> i32\n    x\n\n";
+    for(unsigned int i = 1; i < 400; i++)
+        out << "fun f" << i << ": i32 x -> i32\n    f" << i - 1 << " (x + " << i % 7 << ")\n\n";
+    out << "printf \"%d\\n\" (f399 1)\n";
+}
+
+//Overloads of one function on distinct types
+void genOverloads(ofstream &out){
+    for(unsigned int i = 0; i < 60; i++)
+        out << "type T" << i << " = i32 v" << i << "\n";
+    out << "\n";
+
+    for(unsigned int i = 0; i < 60; i++)
+        out << "fun get: T" << i << " t -> i32\n    t.v" << i << " + " << i << "\n\n";
+
+    out << "var sum = 0\n";
+    for(unsigned int i = 0; i < 60; i++)
+        out << "sum += get (T" << i << " " << i << ")\n";
+    out << "printf \"%d\\n\" sum\n";
+}
+
+//Compile-time functions each evaluated several times
+void genMacros(ofstream &out){
+    for(unsigned int i = 0; i < 20; i++)
+        out << "ante\nfun ct" << i << " :=\n    " << i << " * " << i << "\n\n";
+
+    out << "var sum = 0\n";
+    for(unsigned int i = 0; i < 100; i++)
+        out << "sum += ct" << i % 20 << "()\n";
+    out << "printf \"%d\\n\" sum\n";
+}
+
+//Generic types nested 8 deep with a generic function instantiated on each
+void genNestedGenerics(ofstream &out){
+    out << "type Box 't = 't val\n\n";
+    out << "fun unbox: Box 't b -> 't\n    b.val\n\n";
+    out << "fun identity: 't x -> 't\n    x\n\n";
+
+    out << "let b0 = 1\n";
+    for(unsigned int i = 1; i <= 8; i++)
+        out << "let b" << i << " = Box b" << i - 1 << "\n";
+    for(unsigned int i = 0; i <= 8; i++)
+        out << "let t" << i << " = identity b" << i << "\n";
+
+    out << "\nprintf \"%d\\n\" (unbox (unbox (unbox (unbox (unbox (unbox (unbox (unbox t8))))))))\n";
+}
+
+struct BenchProgram {
+    const char *name, *description;
+    void (*gen)(ofstream&);
+};
+
+bool genBenchPrograms(string dir){
+    BenchProgram programs[] = {
+        {"long_file", "Stresses the lexer, parser and codegen of a single large function.", genLongFile},
+        {"many_functions", "Stresses lazy compilation and function lookup.", genManyFunctions},
+        {"overloads", "Stresses overload resolution in getMangledFuncDecl and typeEq.", genOverloads},
+        {"macros", "Stresses meta-function JIT compilation.", genMacros},
+        {"generics", "Stresses compTemplateFn and AnTypeContainer.", genNestedGenerics},
+    };
+
+    mkdir(dir.c_str(), 0755);
+
+    for(auto &program : programs){
+        string path = dir + "/" + program.name + ".an";
+        ofstream out{path};
+        if(!out){
+            cerr << "Could not open " << path << " for writing\n";
+            return false;
+        }
+
+        out << "/*\n        " << program.name << ".an\n    Generated by angen -bench.\n    "
+            << program.description << "\n*/\n\n";
+        program.gen(out);
+    }
+    return true;
+}
+
+
+int main(int argc, const char **argv){
+    GenArgs args;
+
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "-help") || !strcmp(argv[i], "--help")){
+            printHelp();
+            return 0;
+        }
+
+        if(i + 1 >= argc){
+            cerr << "Option " << argv[i] << " requires an argument\n";
+            return 1;
+        }
+
+        const char *opt = argv[i];
+        const char *val = argv[++i];
+
+        if(!strcmp(opt, "-bench"))               return genBenchPrograms(val) ? 0 : 1;
+        else if(!strcmp(opt, "-o"))              args.outDir = val;
+        else if(!strcmp(opt, "-functions"))      args.functions = atoi(val);
+        else if(!strcmp(opt, "-overloads"))      args.overloads = atoi(val);
+        else if(!strcmp(opt, "-generics"))       args.genericDepth = atoi(val);
+        else if(!strcmp(opt, "-match"))          args.matchArms = atoi(val);
+        else if(!strcmp(opt, "-imports"))        args.imports = atoi(val);
+        else if(!strcmp(opt, "-interpolations")) args.interpolations = atoi(val);
+        else{
+            cerr << "Unknown option " << opt << ", see angen -help\n";
+            return 1;
+        }
+    }
+
+    if(args.outDir.empty()){
+        printHelp();
+        return 1;
+    }
+
+    if(args.overloads == 0) args.overloads = 1;
+
+    mkdir(args.outDir.c_str(), 0755);
+
+    string path = args.outDir + "/main.an";
+    ofstream out{path};
+    if(!out){
+        cerr << "Could not open " << path << " for writing\n";
+        return 1;
+    }
+
+    if(!genImports(args))
+        return 1;
+
+    out << "/*\n        main.an\n    Generated by angen with -functions " << args.functions
+        << " -overloads " << args.overloads << " -generics " << args.genericDepth
+        << " -match " << args.matchArms << " -imports " << args.imports
+        << " -interpolations " << args.interpolations << "\n*/\n";
+
+    if(args.imports > 0)
+        out << "import \"" << args.outDir << "/mod0.an\"\n";
+    out << "\n";
+
+    genFunctions(out, args);
+    if(args.genericDepth > 0) genGenerics(out, args);
+    if(args.matchArms > 0)    genMatch(out, args);
+
+    genFunctionCalls(out, args);
+    if(args.genericDepth > 0)   genGenericCalls(out, args);
+    if(args.matchArms > 0)      genMatchCalls(out, args);
+    if(args.imports > 0)        genImportCalls(out, args);
+    if(args.interpolations > 0) genInterpolations(out, args);
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""
+        run.py
+    Benchmarks the compiler on each program in tests/, bench/programs/, and
+    obj/bench/programs/, where 'make bench' writes the output of 'angen -bench'.
+
+    For each program this records the compile time of each phase reported by
+    -time-report, the total compile time and peak RSS of the compiler, and the
+    runtime of the generated binary.  Results are written as json to be
+    compared against a saved baseline with bench/compare.py.
+
+    usage: bench/run.py [--ante ./ante] [--out obj/bench/results.json] [--runs 3]
+                        [--flags "-O3"] [programs...]
+"""
+import argparse
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+import threading
+import time
+
+#A row of the phase table printed by -time-report:
+#   Wall (s)  Wall %  CPU (s)  Count  Phase (22 columns) Module
+PHASE_ROW = re.compile(r'^\s+([\d.]+)\s+[\d.]+%\s+([\d.]+)\s+(\d+)  (.{22}) (.*)$')
+
+
+def run_measured(cmd, timeout):
+    """Runs cmd and returns its exit status, wall time, peak RSS in KiB, and stderr"""
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE)
+    timer = threading.Timer(timeout, proc.kill)
+    timer.start()
+
+    err = proc.stderr.read()
+    _, status, usage = os.wait4(proc.pid, 0)
+    wall = time.perf_counter() - start
+
+    timer.cancel()
+    proc.stderr.close()
+    proc.returncode = status
+
+    code = os.WEXITSTATUS(status) if os.WIFEXITED(status) else None
+    return code, wall, usage.ru_maxrss, err.decode(errors='replace')
+
+
+def parse_time_report(stderr):
+    """Returns the wall time of each phase summed over every module"""
+    phases = {}
+    in_table = False
+    for line in stderr.splitlines():
+        #the phase table is followed by a blank line and the table of modules
+        if 'Phase' in line:
+            in_table = True
+            continue
+        if not line.strip():
+            in_table = False
+
+        m = PHASE_ROW.match(line)
+        if in_table and m:
+            phase = m.group(4).strip()
+            phases[phase] = phases.get(phase, 0.0) + float(m.group(1))
+    return phases
+
+
+def bench_program(args, path):
+    name = os.path.splitext(os.path.relpath(path))[0]
+    exe = os.path.join(args.objdir, name.replace(os.sep, '_'))
+
+    #a binary left over from a previous run would otherwise be benchmarked if compilation fails
+    if os.path.exists(exe):
+        os.remove(exe)
+
+    cmd = [args.ante, '-time-report'] + args.flags.split() + ['-o', exe, path]
+    status, wall, rss, err = run_measured(cmd, args.timeout)
+    result = {'compile': {'status': status, 'wall': wall, 'maxrss_kb': rss,
+                          'phases': parse_time_report(err)}}
+
+    if status != 0 or args.runs == 0 or not os.path.exists(exe):
+        return name, result
+
+    times = []
+    for _ in range(args.runs):
+        status, wall, rss, _ = run_measured([exe], args.timeout)
+        times.append(wall)
+    result['run'] = {'status': status, 'wall': min(times), 'maxrss_kb': rss}
+    return name, result
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark the ante compiler')
+    parser.add_argument('--ante', default='./ante')
+    parser.add_argument('--out', default='obj/bench/results.json')
+    parser.add_argument('--objdir', default='obj/bench')
+    parser.add_argument('--runs', type=int, default=3, help='runs of each binary, the fastest is kept.  0 skips running them')
+    parser.add_argument('--timeout', type=float, default=60)
+    parser.add_argument('--flags', default='', help='extra flags to compile each program with')
+    parser.add_argument('programs', nargs='*')
+    args = parser.parse_args()
+
+    programs = args.programs or sorted(glob.glob('tests/*.an')) + sorted(glob.glob('bench/programs/*.an')) \
+        + sorted(glob.glob(os.path.join(args.objdir, 'programs', '*.an')))
+    os.makedirs(args.objdir, exist_ok=True)
+
+    results = {}
+    for path in programs:
+        name, result = bench_program(args, path)
+        results[name] = result
+
+        c = result['compile']
+        run = result.get('run')
+        print('%-36s compile %8.3fs %s' % (name, c['wall'], 'run %8.3fs' % run['wall'] if run else
+              '(compile failed)' if c['status'] != 0 else ''), file=sys.stderr)
+
+    rev = subprocess.run(['git', 'rev-parse', '--short', 'HEAD'], stdout=subprocess.PIPE,
+                         stderr=subprocess.DEVNULL).stdout.decode().strip()
+
+    with open(args.out, 'w') as f:
+        json.dump({'commit': rev, 'flags': args.flags, 'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+                   'results': results}, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -187,6 +187,35 @@ namespace ante {
         }
     };
 
+    /** SIMD vector types of a primitive element type, eg. f32x8 */
+    class AnVectorType : public AnType {
+        protected:
+        AnVectorType(AnType* ext, size_t l, AnModifier *m) :
+            AnType(TT_Vector, false, m), extTy(ext), len(l) {}
+
+        public:
+
+        ~AnVectorType() = default;
+
+        /** The element type of each lane. */
+        AnType *extTy;
+
+        /** Number of lanes in the vector. */
+        size_t len;
+
+        static AnVectorType* get(AnType*, size_t len, AnModifier *m = nullptr);
+
+        /** Returns a version of the current type with an additional modifier m. */
+        AnVectorType* addModifier(TokenType m) override;
+
+        /** Returns a version of the current type with the specified modifiers. */
+        AnVectorType* setModifier(AnModifier *m) override;
+
+        static bool classof(const AnType *t){
+            return t->typeTag == TT_Vector;
+        }
+    };
+
     /** Pointer types */
     class AnPtrType : public AnType {
         protected:
@@ -418,6 +447,7 @@ namespace ante {
         friend AnModifier;
         friend AnAggregateType;
         friend AnArrayType;
+        friend AnVectorType;
         friend AnPtrType;
         friend AnTypeVarType;
         friend AnFunctionType;
@@ -427,6 +457,7 @@ namespace ante {
         llvm::StringMap<std::unique_ptr<AnModifier>> modifiers;
         std::map<const AnType*, std::unique_ptr<AnPtrType>> ptrTypes;
         llvm::StringMap<std::unique_ptr<AnArrayType>> arrayTypes;
+        llvm::StringMap<std::unique_ptr<AnVectorType>> vectorTypes;
         llvm::StringMap<std::unique_ptr<AnTypeVarType>> typeVarTypes;
         llvm::StringMap<std::unique_ptr<AnAggregateType>> aggregateTypes;
         llvm::StringMap<std::unique_ptr<AnFunctionType>> functionTypes;
@@ -444,6 +475,13 @@ namespace ante {
         void clearDeclaredTypes(){
             declaredTypes.clear();
         }
+
+        /** Returns the name and number of types held in each container, used by -stats */
+        std::vector<std::pair<const char*, size_t>> getTypeCounts() const;
+
+        /** Returns the approximate bytes used by each container and the types
+         *  it holds in the same order as getTypeCounts, used by -mem-report */
+        std::vector<size_t> getTypeBytes() const;
     };
 }
 
@@ -17,7 +17,22 @@ namespace ante {
         Help,
         Lib,
         EmitLLVM,
-        NoColor
+        NoColor,
+        LTO,
+        ExternalLinker,
+        DynamicLink,
+        CodegenThreads,
+        ProfileGenerate,
+        ProfileUse,
+        MergeFunctions,
+        Incremental,
+        Server,
+        Client,
+        TimeReport,
+        Stats,
+        StatsJson,
+        Trace,
+        MemReport
     };
 
     struct Argument {
@@ -31,6 +46,9 @@ namespace ante {
         std::vector<std::unique_ptr<Argument>> args;
         std::vector<std::string> inputFiles;
 
+        /** @brief Object and bitcode files given as inputs to be passed along to the linker */
+        std::vector<std::string> linkFiles;
+
         void addArg(Argument *a);
         bool hasArg(Args a) const;
         Argument* getArg(Args a) const;
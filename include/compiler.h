@@ -264,6 +264,7 @@ namespace ante {
         void* operator()(Compiler *c, TypedValue &tv);
         void* operator()(TypedValue &p1, TypedValue &p2);
         void* operator()(Compiler *c, TypedValue &tv1, TypedValue &tv2);
+        void* operator()(Compiler *c, TypedValue &tv1, TypedValue &tv2, TypedValue &tv3);
     };
 
 
@@ -332,6 +333,14 @@ namespace ante {
 
         /** @brief functions to run whenever a function is declared. */
         std::vector<std::shared_ptr<FuncDecl>> on_fn_decl_hook;
+
+        /**
+         * @brief Number of compile-time function calls evaluated so far.  Functions
+         * whose compilation evaluates any have side effects and are not cached.
+         */
+        unsigned int ctEvaluations;
+
+        CompilerCtCtxt() : ctStores(), on_fn_decl_hook(), ctEvaluations(0){}
     };
 
     /**
@@ -354,6 +363,13 @@ namespace ante {
         /** @brief all imported modules */
         std::vector<Module*> imports;
 
+        /**
+         * @brief Compiled instances of each generic function grouped by their
+         * FuncDeclNode and llvm function type.  Used to reuse identical instances
+         * whose type arguments have the same layout.
+         */
+        llvm::StringMap<std::vector<llvm::Function*>> layoutInstances;
+
         /**
          * @brief Stack of variables mapped to their identifier.
          * Maps are seperated according to their scope.
@@ -368,6 +384,48 @@ namespace ante {
         std::string fileName, outFile, funcPrefix;
         unsigned int scope, optLvl, fnScope;
 
+        /**
+        * @brief Set by -flto.  Object files are emitted as llvm bitcode and
+        * bitcode inputs are merged into this module before native code is emitted.
+        */
+        bool lto;
+
+        /** @brief Object and bitcode files to include when linking */
+        std::vector<std::string> linkFiles;
+
+        /** @brief Set by -dynamic to link against shared libraries instead of with -static */
+        bool dynamicLink;
+
+        /** @brief Set by -external-linker to use AN_LINKER even when lld is available in-process */
+        bool externalLinker;
+
+        /** @brief Number of partitions/threads used to emit native code, set by -j */
+        unsigned int codegenThreads;
+
+        /** @brief Set by -fprofile-generate to instrument the module and link the profile runtime */
+        bool profileGenerate;
+
+        /** @brief Name of the .profdata file set by -fprofile-use=<file>, empty if unused */
+        std::string profileUse;
+
+        /**
+        * @brief Set when compiling with PGO.  Per-function optimizations are then
+        * delayed until applyProfile is called with the fully compiled module.
+        */
+        bool deferFnPasses;
+
+        /** @brief Set by -fmerge-functions to run llvm's MergeFunctions pass at -O2 and above */
+        bool mergeFunctions;
+
+        /** @brief Set once runModulePasses has run so -emit-llvm and compileNative do not run them twice */
+        bool modulePassesRun;
+
+        /** @brief Directory of the function cache set by -incremental <dir>, empty if unused */
+        std::string cacheDir;
+
+        /** @brief Every function compiled by this Compiler indexed by mangled name */
+        llvm::StringMap<FuncDecl*> compiledFns;
+
         /**
         * @brief The main constructor for Compiler
         *
@@ -724,18 +782,74 @@ namespace ante {
         */
         int compileIRtoObj(llvm::Module *mod, std::string outFile);
 
+        /**
+        * @brief Splits a module into partitions and compiles each into
+        * an obj file on its own thread.
+        *
+        * Each partition is serialized to bitcode and reloaded into its own
+        * LLVMContext so the threads share no llvm state.  The given module
+        * is left unmodified.
+        *
+        * @param mod The already-compiled module
+        * @param outFile Base name of the obj files to output
+        * @param partitions The number of partitions and threads to use
+        * @param objFiles Filled with the name of each obj file created
+        *
+        * @return 0 on success
+        */
+        int compileIRtoObjParallel(llvm::Module *mod, std::string outFile, unsigned int partitions,
+                std::vector<std::string> &objFiles);
+
+        /**
+        * @brief Writes a module as llvm bitcode to be merged at link-time with -flto.
+        *
+        * @param mod The already-compiled module
+        * @param outFile Name of the file to output
+        *
+        * @return 0 on success
+        */
+        int compileIRtoBitcode(llvm::Module *mod, std::string outFile);
+
+        /**
+        * @brief Adds PGO instrumentation if profileGenerate is set or annotates
+        * the module with branch weights and entry counts from profileUse.
+        * Afterward, runs the per-function optimizations that were deferred.
+        */
+        void applyProfile();
+
+        /**
+        * @brief Runs the module-level passes over the finished module before
+        * it is emitted.  At -O2 and above this inlines functions marked
+        * ![inline] then vectorizes the loops they were called in.
+        */
+        void runModulePasses();
+
+        /**
+        * @brief Merges each bitcode file in linkFiles into the current module,
+        * internalizes every symbol other than main, and runs the module-level
+        * optimization pipeline over the result.
+        *
+        * Non-bitcode files in linkFiles are returned to be passed to the linker.
+        *
+        * @return A space-separated list of the remaining non-bitcode inputs
+        */
+        std::string linkTimeOptimize();
+
         TypedValue getVoidLiteral();
 
         /**
-        * @brief Invokes the linker specified by AN_LINKER (in target.h) to
-        *        link each object file
+        * @brief Links each object file into an executable.
+        *
+        * If ante was built with AN_USE_LLD the objects are linked in-process
+        * through lld unless externalLinker is set, otherwise the linker specified
+        * by AN_LINKER (in target.h) is invoked.
         *
         * @param inFiles String containing each obj file to link separated with spaces
         * @param outFile Name of the file to output
         *
         * @return 0 on success
         */
-        static int linkObj(std::string inFiles, std::string outFile);
+        int linkObj(std::string inFiles, std::string outFile);
     };
 
     /**
@@ -765,6 +879,14 @@ namespace ante {
      */
     void init_compapi();
 
+    /**
+     * @brief Gives ante_parallel_for a serial definition in mod if it is declared there.
+     *
+     * The thread pool behind parallel_for is in runtime.o, which is only linked
+     * into executables, so JIT compiled and interpreted code runs it serially.
+     */
+    void defineSerialParallelFor(llvm::Module *mod);
+
     /**
     * @brief Compiles all top-level import expressions
     */
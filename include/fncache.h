@@ -0,0 +1,39 @@
+#ifndef AN_FNCACHE_H
+#define AN_FNCACHE_H
+
+#include "compiler.h"
+
+namespace ante {
+
+    /**
+     * @brief Computes the key a function body is stored under in the
+     * incremental compilation cache set by -incremental <dir>.
+     *
+     * The key is a hash of the function's source, its mangled name, and its
+     * resolved signature.  The signatures of its callees are checked separately
+     * when the cached function is loaded since they are not known until the
+     * function is compiled.
+     *
+     * @return The key or an empty string if the function cannot be cached
+     */
+    std::string getFnCacheKey(Compiler *c, FuncDecl *fd, AnType *fnTy);
+
+    /**
+     * @brief Loads the previously compiled and optimized body of the
+     * function with the given key into the current module.
+     *
+     * Each callee the cached body references is compiled if it is not already
+     * and its signature is checked to be unchanged.
+     *
+     * @return The loaded function or nullptr if the cache entry is missing or out of date
+     */
+    llvm::Function* loadCachedFn(Compiler *c, FuncDecl *fd, std::string &key);
+
+    /**
+     * @brief Stores the compiled body of a function along with the signature
+     * of each of its callees under the given key.
+     */
+    void storeCachedFn(Compiler *c, FuncDecl *fd, llvm::Function *f, std::string &key);
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <memory>
 #include "lexer.h"
 #include "tokens.h"
+#include "stats.h"
 #include "location.hh"
 
 #ifndef LOC_TY
@@ -293,6 +294,21 @@ namespace ante {
             ~StrLitNode(){}
         };
 
+        /*
+         * A Str literal containing one or more ${expr} sites.  Each expr
+         * is parsed along with the literal so it is only parsed once.
+         */
+        struct InterpolatedStrNode : public Node{
+            //The literal pieces surrounding each expr, there is always one more than exprs
+            std::vector<std::string> strs;
+            std::vector<std::unique_ptr<Node>> exprs;
+
+            TypedValue compile(Compiler*);
+            void print(void);
+            InterpolatedStrNode(LOC_TY& loc) : Node(loc), strs(), exprs(){}
+            ~InterpolatedStrNode(){}
+        };
+
         struct LetBindingNode : public Node{
             std::string name;
             std::unique_ptr<Node> modifiers, typeExpr, expr;
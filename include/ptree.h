@@ -45,6 +45,7 @@ namespace ante {
 
         Node* mkGlobalNode(LOC_TY loc, Node* s);
         Node* mkTypeNode(LOC_TY loc, TypeTag type, char* typeName, Node *extTy = nullptr);
+        Node* mkSimdTypeNode(LOC_TY loc, char* s);
         Node* mkTypeCastNode(LOC_TY loc, Node *l, Node *r);
         Node* mkUnOpNode(LOC_TY loc, int op, Node *r);
         Node* mkBinOpNode(LOC_TY loc, int op, Node* l, Node* r);
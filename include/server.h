@@ -0,0 +1,40 @@
+#ifndef AN_SERVER_H
+#define AN_SERVER_H
+
+#include <memory>
+#include <llvm/IR/LLVMContext.h>
+#include "args.h"
+
+namespace ante {
+
+    /**
+     * @brief Compiles each input file according to the given arguments.
+     *
+     * Defined in ante.cpp.
+     *
+     * @param args The parsed command line arguments
+     * @param ctxt An LLVMContext to compile within or nullptr to create a new one per file
+     */
+    void compileInputs(CompilerArgs *args, std::shared_ptr<llvm::LLVMContext> ctxt = nullptr);
+
+    /**
+     * @brief Runs a compile server listening on the given unix socket.
+     *
+     * The prelude is parsed and declared once when the server starts.  Each
+     * request is then compiled in a process forked from this warm state so
+     * requests only pay for compiling the user's code.
+     *
+     * @return Nonzero if the server could not be started, otherwise never returns
+     */
+    int runServer(const char *socketPath);
+
+    /**
+     * @brief Forwards the current command line, working directory, stdout, and stderr
+     * to the compile server listening on the given socket.
+     *
+     * @return The exit status of the compilation performed by the server
+     */
+    int runClient(const char *socketPath, int argc, const char **argv);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef AN_STATS_H
+#define AN_STATS_H
+
+#include <cstddef>
+#include <string>
+#include <typeinfo>
+
+namespace ante {
+
+    /* forward-decls from compiler.h */
+    struct Compiler;
+
+    /**
+     * @brief Counters for the compiler's hot paths reported by -stats and -stats-json.
+     *
+     * Each counter is a plain increment so they are always collected.  There
+     * are no timings so the output of a given input is the same on every run.
+     */
+    struct CompilerStats {
+        /** @brief Calls to Compiler::typeEq and to typeEqHelper including recursive calls */
+        size_t typeEqCalls, typeEqHelperCalls;
+
+        /** @brief Current and deepest recursion of typeEqHelper */
+        size_t typeEqDepth, typeEqMaxDepth;
+
+        /** @brief Calls to getMangledFuncDecl and the total candidates left after filtering by argc and scope */
+        size_t getMangledFuncDeclCalls, fnCandidates;
+
+        /** @brief Generic functions compiled with a new set of type arguments */
+        size_t templateInstantiations;
+
+        /** @brief Calls to compMetaFunctionResult, the time spent in them is reported by -time-report */
+        size_t metaFunctionCalls;
+
+        /** @brief Calls to free inserted by exitScope */
+        size_t exitScopeFrees;
+
+        /** @brief Parse tree nodes created by the parser, see recordAstNode */
+        size_t astNodes;
+    };
+
+    extern CompilerStats stats;
+
+    /** @brief Tracks the recursion depth of a function for the duration of its scope */
+    struct StatDepth {
+        size_t &depth;
+
+        StatDepth(size_t &depth, size_t &maxDepth) : depth(depth){
+            if(++depth > maxDepth) maxDepth = depth;
+        }
+        ~StatDepth(){ depth--; }
+    };
+
+    /**
+     * @brief Prints each counter, the number of types in each type container,
+     * and the llvm instruction counts of the largest functions in c's module to stderr.
+     */
+    void printStats(Compiler *c);
+
+    /** @brief Returns the same statistics as printStats as a json object */
+    std::string statsToJson(Compiler *c);
+
+    /** @brief Sets every counter to zero, called between input files */
+    void resetStats();
+
+    /** @brief Records a parse tree node of the given kind and size for -mem-report */
+    void recordAstNode(const std::type_info &kind, size_t bytes);
+
+    /**
+     * @brief Prints the memory used by the type containers, parse tree, ante modules,
+     * and c's llvm module along with the peak RSS of the compiler to stderr.
+     */
+    void printMemReport(Compiler *c);
+
+    /** @brief Quotes and escapes a string for use in json */
+    std::string jsonStr(const std::string &s);
+}
+
+#endif
@@ -141,6 +141,34 @@
 #  define AN_EXEC_STR "./"
 #endif
 
+//Paths used by the in-process lld linker, normally set by the Makefile
+//from the paths reported by gcc
+#ifndef AN_CRT_DIR
+#  define AN_CRT_DIR "/usr/lib"
+#endif
+
+#ifndef AN_GCC_LIB_DIR
+#  define AN_GCC_LIB_DIR "/usr/lib/gcc"
+#endif
+
+//Profile runtime linked into executables built with -fprofile-generate
+#ifndef AN_PROFILE_RT
+#  define AN_PROFILE_RT "-lclang_rt.profile-" AN_NATIVE_ARCH
+#endif
+
+//Runtime linked into executables that call parallel_for, installed by 'make stdlib'
+#ifndef AN_RUNTIME
+#  define AN_RUNTIME AN_LIB_DIR "runtime.o"
+#endif
+
+#ifndef AN_DYNAMIC_LINKER
+#  if defined __x86_64__ && defined __linux__
+#    define AN_DYNAMIC_LINKER "/lib64/ld-linux-x86-64.so.2"
+#  else
+#    define AN_DYNAMIC_LINKER "/lib/ld-linux.so.2"
+#  endif
+#endif
+
 
 #ifndef AN_TARGET_TRIPLE
 #  define AN_TARGET_TRIPLE AN_NATIVE_ARCH "-" AN_NATIVE_VENDOR "-" AN_NATIVE_OS
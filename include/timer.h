@@ -0,0 +1,92 @@
+#ifndef AN_TIMER_H
+#define AN_TIMER_H
+
+#include <chrono>
+#include <string>
+
+namespace ante {
+
+    /**
+     * @brief Records the wall and cpu time spent in a compilation phase
+     * for the duration of its scope when -time-report is enabled.
+     *
+     * Timers may be nested.  Time is only attributed to the innermost running
+     * timer so the times of every phase and module add up to the total time.
+     */
+    class ScopedTimer {
+        const char *phase;
+        const std::string *module;
+        ScopedTimer *parent;
+
+        std::chrono::steady_clock::time_point wallStart;
+        double cpuStart;
+
+        /** @brief Time spent in nested timers, excluded from this phase */
+        double childWall, childCpu;
+
+    public:
+        /**
+         * @param phase Name of the phase being timed
+         * @param module File name of the module the time is attributed to.
+         *               Must outlive this timer.
+         */
+        ScopedTimer(const char *phase, const std::string &module);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+    /** @brief True if -time-report was passed and phases should be timed */
+    extern bool timeReportEnabled;
+
+    /**
+     * @brief Starts recording the time of each phase and prints
+     * the report once the compiler exits.
+     */
+    void enableTimeReport();
+
+    /**
+     * @brief Prints the time of each phase and module recorded so far to stderr,
+     * sorted by wall time, then clears the recorded times.
+     */
+    void printTimeReport();
+
+
+    /**
+     * @brief Records a Chrome trace event spanning its scope when -trace is enabled.
+     *
+     * Events nest by time so on-demand compilation of functions within
+     * other functions is shown as a flame chart by chrome://tracing or Perfetto.
+     */
+    class TraceEvent {
+        const char *category;
+        std::string name;
+        std::string args;
+        double start;
+
+    public:
+        TraceEvent(const char *category, const std::string &name);
+        ~TraceEvent();
+
+        /** @brief Adds an argument shown when the event is selected */
+        void addArg(const char *key, const std::string &val);
+
+        TraceEvent(const TraceEvent&) = delete;
+        TraceEvent& operator=(const TraceEvent&) = delete;
+    };
+
+    /** @brief True if -trace was passed and trace events should be recorded */
+    extern bool traceEnabled;
+
+    /**
+     * @brief Starts recording trace events and writes them
+     * to the given file once the compiler exits.
+     */
+    void enableTrace(const std::string &file);
+
+    /** @brief Writes the trace events recorded so far to the file given to enableTrace */
+    void writeTrace();
+}
+
+#endif
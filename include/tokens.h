@@ -18,6 +18,7 @@ namespace ante {
 		TT_Bool,
 		TT_Tuple,
 		TT_Array,
+		TT_Vector, //SIMD vectors of a primitive type, eg. f32x8
 		TT_Ptr,
 		TT_Data, //all previously declared UserTypes
 		TT_TypeVar,
@@ -52,6 +53,7 @@ namespace ante {
 		Tok_C32,
 		Tok_Bool,
 		Tok_Void,
+		Tok_SimdType, //vector types, eg. f32x8
 
 		/*operators*/
 		Tok_Eq,
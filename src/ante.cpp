@@ -7,7 +7,10 @@
 #include "yyparser.h"
 #include "args.h"
 #include "target.h"
+#include "server.h"
+#include "timer.h"
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <llvm/Support/TargetRegistry.h>
 
@@ -49,12 +52,27 @@ void printHelp(){
     puts("\t-o <filename>\tspecify output name");
     puts("\t-p\t\tprint parse tree");
     puts("\t-O <number>\tSet optimization level. Arg of 0 = none, 3 = all");
+    puts("\t-j <number>\tsplit native code generation across the given number of threads");
     puts("\t-r\t\tcompile and run");
     puts("\t-help\t\tprint this message");
     puts("\t-lib\t\tcompile as library (include all functions in binary and compile to object file)");
     puts("\t-emit-llvm\tprint llvm-IR as output");
     puts("\t-check\t\tCheck program for errors without compiling");
     puts("\t-no-color\tprint uncolored output");
+    puts("\t--server <socket>   run a compile server listening on the given unix socket");
+    puts("\t--client <socket>   forward this command line to the compile server on the given socket");
+    puts("\t-dynamic\tlink dynamically against the C library instead of statically");
+    puts("\t-external-linker invoke the system linker (" AN_LINKER ") instead of linking in-process");
+    puts("\t-fprofile-generate  instrument the program to write a profile to default.profraw when run");
+    puts("\t-fprofile-use=<file> optimize using a profile merged with llvm-profdata");
+    puts("\t-fmerge-functions  merge identical functions at -O2 and above");
+    puts("\t-incremental <dir>  reuse the compiled bodies of unchanged functions cached in dir");
+    puts("\t-stats\t\tprint counts of the work done by the compiler and the size of each function");
+    puts("\t-stats-json=<file> write the same statistics as -stats to file as json");
+    puts("\t-mem-report\tprint the memory used by types, the parse tree, and the llvm module");
+    puts("\t-trace=<file>\twrite a chrome trace of the compilation of each function to file");
+    puts("\t-time-report\tprint the time spent in each compilation phase and module");
+    puts("\t-flto\t\tenable link-time optimization (-c emits llvm bitcode, which is merged when linking)");
 
     puts("\nNative target: " AN_TARGET_TRIPLE);
 
@@ -63,6 +81,48 @@ void printHelp(){
 
 namespace ante {
     extern AnTypeContainer typeArena;
+
+    void compileInputs(CompilerArgs *args, shared_ptr<llvm::LLVMContext> ctxt){
+        if(args->hasArg(Args::TimeReport))
+            enableTimeReport();
+
+        if(auto *trace = args->getArg(Args::Trace))
+            enableTrace(trace->arg);
+
+        auto *statsJson = args->getArg(Args::StatsJson);
+        string json = "";
+
+        for(auto input : args->inputFiles){
+            resetStats();
+            Compiler ante{input.c_str(), false, ctxt};
+            if(args->hasArg(Args::Parse)){
+                parser::printBlock(ante.ast.get());
+            }
+
+            ante.processArgs(args);
+
+            if(args->hasArg(Args::Stats))
+                printStats(&ante);
+
+            if(args->hasArg(Args::MemReport))
+                printMemReport(&ante);
+
+            if(statsJson)
+                json += (json.empty() ? "{\n" : ",\n") + (jsonStr(input) + ": ") + statsToJson(&ante);
+
+            typeArena.clearDeclaredTypes();
+            allCompiledModules.clear();
+            allMergedCompUnits.clear();
+        }
+
+        if(statsJson && !json.empty()){
+            ofstream out{statsJson->arg};
+            if(out)
+                out << json << "\n}\n";
+            else
+                cerr << "Could not open " << statsJson->arg << " to write statistics\n";
+        }
+    }
 }
 
 int main(int argc, const char **argv){
@@ -72,20 +132,13 @@ int main(int argc, const char **argv){
     init_compapi();
 
     auto *args = parseArgs(argc, argv);
+    if(auto *arg = args->getArg(Args::Client)) return runClient(arg->arg.c_str(), argc, argv);
+    if(auto *arg = args->getArg(Args::Server)) return runServer(arg->arg.c_str());
+
     if(args->hasArg(Args::Help)) printHelp();
     if(args->hasArg(Args::NoColor)) colored_output = false;
 
-    for(auto input : args->inputFiles){
-        Compiler ante{input.c_str()};
-        if(args->hasArg(Args::Parse)){
-            parser::printBlock(ante.ast.get());
-        }
-
-        ante.processArgs(args);
-        typeArena.clearDeclaredTypes();
-        allCompiledModules.clear();
-        allMergedCompUnits.clear();
-    }
+    compileInputs(args);
 
     if(args->hasArg(Args::Eval) or (args->args.empty() and args->inputFiles.empty()))
         Compiler(0).eval();
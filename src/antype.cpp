@@ -256,6 +256,17 @@ namespace ante {
         return arr;
     }
 
+    AnVectorType* AnVectorType::get(AnType* t, size_t len, AnModifier *m){
+        auto key = modifiersToStr(m) + anTypeToStr(t) + "x" + to_string(len);
+
+        auto existing_ty = search(typeArena.vectorTypes, key);
+        if(existing_ty) return existing_ty;
+
+        auto vec = new AnVectorType(t, len, m);
+        typeArena.vectorTypes.try_emplace(key, vec);
+        return vec;
+    }
+
     string getKey(const std::vector<AnType*> &exts){
         string ret = "";
         for(auto &ext : exts){
@@ -730,6 +741,86 @@ namespace ante {
         typeArena.primitiveTypes[TT_FunctionList].reset(new AnType(TT_FunctionList, false, nullptr));
     }
 
+    vector<pair<const char*, size_t>> AnTypeContainer::getTypeCounts() const{
+        return {
+            {"primitiveTypes", primitiveTypes.size()},
+            {"modifiers",      modifiers.size()},
+            {"ptrTypes",       ptrTypes.size()},
+            {"arrayTypes",     arrayTypes.size()},
+            {"vectorTypes",    vectorTypes.size()},
+            {"typeVarTypes",   typeVarTypes.size()},
+            {"aggregateTypes", aggregateTypes.size()},
+            {"functionTypes",  functionTypes.size()},
+            {"declaredTypes",  declaredTypes.size()},
+            {"otherTypes",     otherTypes.size()},
+        };
+    }
+
+    //Bytes of a type's own fields along with the vectors and strings it owns
+    size_t typeBytes(const AnType *t){
+        if(auto *agg = llvm::dyn_cast<AnAggregateType>(t)){
+            size_t bytes = agg->extTys.capacity() * sizeof(AnType*);
+
+            if(auto *dt = llvm::dyn_cast<AnDataType>(t)){
+                bytes += sizeof(AnDataType) + dt->name.capacity()
+                    + dt->fields.capacity() * sizeof(string)
+                    + dt->tags.capacity() * sizeof(shared_ptr<UnionTag>)
+                    + dt->traitImpls.capacity() * sizeof(shared_ptr<Trait>)
+                    + dt->variants.capacity() * sizeof(AnDataType*)
+                    + dt->generics.capacity() * sizeof(AnTypeVarType*)
+                    + dt->boundGenerics.capacity() * sizeof(pair<string, AnType*>);
+            }else if(llvm::isa<AnFunctionType>(t)){
+                bytes += sizeof(AnFunctionType);
+            }else{
+                bytes += sizeof(AnAggregateType);
+            }
+            return bytes;
+        }
+
+        if(auto *tv = llvm::dyn_cast<AnTypeVarType>(t)) return sizeof(AnTypeVarType) + tv->name.capacity();
+        if(llvm::isa<AnArrayType>(t)) return sizeof(AnArrayType);
+        if(llvm::isa<AnVectorType>(t)) return sizeof(AnVectorType);
+        if(llvm::isa<AnPtrType>(t)) return sizeof(AnPtrType);
+        return sizeof(AnType);
+    }
+
+    template<typename T>
+    size_t containerBytes(const llvm::StringMap<unique_ptr<T>> &map){
+        size_t bytes = map.getNumBuckets() * (sizeof(void*) + sizeof(unsigned));
+        for(auto &entry : map)
+            bytes += sizeof(entry) + entry.getKeyLength() + 1 + typeBytes(entry.second.get());
+        return bytes;
+    }
+
+    template<typename K, typename T>
+    size_t containerBytes(const map<K, unique_ptr<T>> &m){
+        //each std::map node holds its value and three pointers and a color
+        size_t bytes = 0;
+        for(auto &entry : m)
+            bytes += sizeof(entry) + 4 * sizeof(void*) + typeBytes(entry.second.get());
+        return bytes;
+    }
+
+    vector<size_t> AnTypeContainer::getTypeBytes() const{
+        size_t modBytes = modifiers.getNumBuckets() * (sizeof(void*) + sizeof(unsigned));
+        for(auto &entry : modifiers)
+            modBytes += sizeof(entry) + entry.getKeyLength() + 1 + sizeof(AnModifier)
+                + entry.second->modifiers.capacity() * sizeof(TokenType);
+
+        return {
+            containerBytes(primitiveTypes),
+            modBytes,
+            containerBytes(ptrTypes),
+            containerBytes(arrayTypes),
+            containerBytes(vectorTypes),
+            containerBytes(typeVarTypes),
+            containerBytes(aggregateTypes),
+            containerBytes(functionTypes),
+            containerBytes(declaredTypes),
+            containerBytes(otherTypes),
+        };
+    }
+
 
     AnType* AnType::getFunctionReturnType() const{
         return ((AnFunctionType*)this)->retTy;
@@ -799,6 +890,11 @@ namespace ante {
                 IntLitNode *len = (IntLitNode*)elemTy->next.get();
                 return AnArrayType::get(toAnType(c, elemTy), len ? stoi(len->val) : 0, mods);
             }
+            case TT_Vector: {
+                TypeNode *elemTy = tn->extTy.get();
+                IntLitNode *len = (IntLitNode*)elemTy->next.get();
+                return AnVectorType::get(toAnType(c, elemTy), stoi(len->val), mods);
+            }
             case TT_Ptr:
                 return AnPtrType::get(toAnType(c, tn->extTy.get()), mods);
             case TT_Data:
@@ -867,6 +963,21 @@ namespace ante {
         return AnArrayType::get(extTy->setModifier(anmod), len, anmod);
     }
 
+    AnVectorType* AnVectorType::addModifier(TokenType m){
+        if(mods){
+            if(hasModifier(m)){
+                return this;
+            }else{
+                auto modifiers = mods->modifiers;
+                modifiers.push_back(m);
+                auto *anmod = AnModifier::get(modifiers);
+                return AnVectorType::get(extTy->setModifier(anmod), len, anmod);
+            }
+        }
+        auto *anmod = AnModifier::get({m});
+        return AnVectorType::get(extTy->setModifier(anmod), len, anmod);
+    }
+
     AnPtrType* AnPtrType::addModifier(TokenType m){
         if(mods){
             if(hasModifier(m)){
@@ -953,6 +1064,14 @@ namespace ante {
         }
     }
 
+    AnVectorType* AnVectorType::setModifier(AnModifier *m){
+        if(this->mods == m){
+            return this;
+        }else{
+            return AnVectorType::get(extTy->setModifier(m), len, m);
+        }
+    }
+
     AnPtrType* AnPtrType::setModifier(AnModifier *m){
         if(this->mods == m){
             return this;
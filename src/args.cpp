@@ -1,6 +1,7 @@
 #include "args.h"
 #include <map>
 #include <iostream>
+#include <cstring>
 
 using namespace ante;
 using namespace std;
@@ -16,7 +17,22 @@ map<string, Args> argsMap = {
     {"-help",      Args::Help},
     {"-lib",       Args::Lib},
     {"-emit-llvm", Args::EmitLLVM},
-    {"-no-color",  Args::NoColor}
+    {"-no-color",  Args::NoColor},
+    {"-flto",      Args::LTO},
+    {"-external-linker", Args::ExternalLinker},
+    {"-dynamic",   Args::DynamicLink},
+    {"-j",         Args::CodegenThreads},
+    {"-fprofile-generate", Args::ProfileGenerate},
+    {"-fprofile-use",      Args::ProfileUse},
+    {"-fmerge-functions",  Args::MergeFunctions},
+    {"-incremental",       Args::Incremental},
+    {"--server",           Args::Server},
+    {"--client",           Args::Client},
+    {"-time-report",       Args::TimeReport},
+    {"-stats",             Args::Stats},
+    {"-stats-json",        Args::StatsJson},
+    {"-trace",             Args::Trace},
+    {"-mem-report",        Args::MemReport}
 };
 
 void CompilerArgs::addArg(Argument *a){
@@ -48,10 +64,10 @@ bool CompilerArgs::empty() const{
 enum ArgTy { None, Str, Int };
 
 ArgTy requiresArg(Args a){
-    if(a == OutputName)
+    if(a == OutputName || a == ProfileUse || a == Incremental || a == Server || a == Client || a == StatsJson || a == Trace)
         return ArgTy::Str;
 
-    if(a == OptLvl)
+    if(a == OptLvl || a == CodegenThreads)
         return ArgTy::Int;
 
     return ArgTy::None;
@@ -64,24 +80,48 @@ string argTyToStr(ArgTy ty){
 }
 
 
+/*
+ *  Returns true if the given input file is an already-compiled object
+ *  or bitcode file that should be linked rather than compiled.
+ */
+bool isLinkInput(string file){
+    auto index = file.find_last_of('.');
+    if(index == string::npos) return false;
+
+    string ext = file.substr(index);
+    return ext == ".o" || ext == ".ao" || ext == ".bc" || ext == ".a";
+}
+
+
 CompilerArgs* ante::parseArgs(int argc, const char** argv){
     CompilerArgs* ret = new CompilerArgs();
 
     for(int i = 1; i < argc; i++){
         if(argv[i][0] == '-'){
             try{
-                Args a = argsMap.at(argv[i]);
+                //parameters may also be given inline, eg. -fprofile-use=<filename>
+                string argName = argv[i];
+                auto eq = argName.find('=');
+                if(eq != string::npos)
+                    argName = argName.substr(0, eq);
+
+                Args a = argsMap.at(argName);
                 string s = "";
 
                 //check to see if this argument requires an addition arg, eg -c <filename>
                 ArgTy ty;
                 if((ty = requiresArg(a)) != ArgTy::None){
-                    if(i + 1 < argc && argv[i+1][0] != '-'){
+                    if(eq != string::npos && eq + 1 < strlen(argv[i])){
+                        s = argv[i] + eq + 1;
+                    }else if(eq == string::npos && i + 1 < argc && argv[i+1][0] != '-'){
                         s = argv[++i];
                     }else{
                         cerr << "Argument '" << argv[i] << "' requires a " << argTyToStr(ty) << " parameter.\n";
                         exit(1);
                     }
+                }else if(eq != string::npos){
+                    cerr << "Argument '" << argName << "' does not take a parameter.\n";
+                    exit(1);
                 }
 
                 ret->addArg(new Argument(a, s));
@@ -93,6 +133,8 @@ CompilerArgs* ante::parseArgs(int argc, const char** argv){
 
         //if it is not an option denoted by '-' it is an input file
         //options requiring their own arguments are already taken care of
+        }else if(isLinkInput(argv[i])){
+            ret->linkFiles.push_back(argv[i]);
         }else{
             ret->inputFiles.push_back(argv[i]);
         }
@@ -68,6 +68,85 @@ extern "C" {
         }
     }
 
+    /*
+     *  Shuffles the lanes of two vectors of the same type into a new vector.
+     *  Each lane of the result is given by an index in lanes, which must be a
+     *  constant integer or tuple of integers, into the concatenation of a and b.
+     */
+    TypedValue* Ante_shuffle(Compiler *c, TypedValue &a, TypedValue &b, TypedValue &lanes){
+        auto *vecTy = (AnVectorType*)a.type;
+        if(!c->typeEq(a.type, b.type))
+            c->compErr("Ante.shuffle: Both vectors must be the same type, but got "
+                    + anTypeToColoredStr(a.type) + " and " + anTypeToColoredStr(b.type));
+
+        vector<Constant*> mask;
+        auto *lanesVal = dyn_cast<Constant>(lanes.val);
+        unsigned numLanes = lanes.type->typeTag == TT_Tuple ? ((AnAggregateType*)lanes.type)->extTys.size() : 1;
+
+        for(unsigned i = 0; lanesVal and i < numLanes; i++){
+            auto *lane = dyn_cast_or_null<ConstantInt>(numLanes == 1 ? lanesVal : lanesVal->getAggregateElement(i));
+            if(!lane or lane->getZExtValue() >= vecTy->len * 2)
+                c->compErr("Ante.shuffle: Lane indices must be integer literals less than " + to_string(vecTy->len * 2));
+
+            mask.push_back(c->builder.getInt32(lane->getZExtValue()));
+        }
+
+        if(mask.size() != numLanes)
+            c->compErr("Ante.shuffle: Lane indices must be known at compile time");
+
+        Value *res = c->builder.CreateShuffleVector(a.val, b.val, ConstantVector::get(mask));
+        return new TypedValue(res, AnVectorType::get(vecTy->extTy, numLanes));
+    }
+
+    /*
+     *  Combines l and r element-wise with the given reduction operator
+     */
+    Value* combineLanes(Compiler *c, char op, Value *l, Value *r, AnType *elemTy){
+        bool isFlt = isFPTypeTag(elemTy->typeTag);
+        bool isUnsigned = isUnsignedTypeTag(elemTy->typeTag);
+
+        switch(op){
+            case '+': return isFlt ? c->builder.CreateFAdd(l, r) : c->builder.CreateAdd(l, r);
+            case '*': return isFlt ? c->builder.CreateFMul(l, r) : c->builder.CreateMul(l, r);
+            case '<':
+                return c->builder.CreateSelect(isFlt ? c->builder.CreateFCmpOLT(l, r)
+                        : isUnsigned ? c->builder.CreateICmpULT(l, r) : c->builder.CreateICmpSLT(l, r), l, r);
+            default:
+                return c->builder.CreateSelect(isFlt ? c->builder.CreateFCmpOGT(l, r)
+                        : isUnsigned ? c->builder.CreateICmpUGT(l, r) : c->builder.CreateICmpSGT(l, r), l, r);
+        }
+    }
+
+    /*
+     *  Reduces every lane of a vector to a single value by repeatedly combining
+     *  its low and high halves, taking log2 of its length steps.
+     */
+    TypedValue* reduceVector(Compiler *c, char op, TypedValue &v){
+        auto *vecTy = (AnVectorType*)v.type;
+        Value *res = v.val;
+
+        for(size_t len = vecTy->len; len > 1; len /= 2){
+            vector<Constant*> lo, hi;
+            for(size_t i = 0; i < len / 2; i++){
+                lo.push_back(c->builder.getInt32(i));
+                hi.push_back(c->builder.getInt32(i + len / 2));
+            }
+
+            Value *undef = UndefValue::get(res->getType());
+            Value *l = c->builder.CreateShuffleVector(res, undef, ConstantVector::get(lo));
+            Value *r = c->builder.CreateShuffleVector(res, undef, ConstantVector::get(hi));
+            res = combineLanes(c, op, l, r, vecTy->extTy);
+        }
+
+        res = c->builder.CreateExtractElement(res, c->builder.getInt32(0));
+        return new TypedValue(res, vecTy->extTy);
+    }
+
+    TypedValue* Ante_reduce_add(Compiler *c, TypedValue &v){ return reduceVector(c, '+', v); }
+    TypedValue* Ante_reduce_mul(Compiler *c, TypedValue &v){ return reduceVector(c, '*', v); }
+    TypedValue* Ante_reduce_min(Compiler *c, TypedValue &v){ return reduceVector(c, '<', v); }
+    TypedValue* Ante_reduce_max(Compiler *c, TypedValue &v){ return reduceVector(c, '>', v); }
+
     void Ante_forget(Compiler *c, TypedValue &msgTv){
         char *msg = (char*)typedValueToGenericValue(c, msgTv).PointerVal;
         c->mergedCompUnits->fnDecls[msg].clear();
@@ -86,6 +165,11 @@ namespace ante {
         compapi.emplace("Ante_ctError",     new CtFunc((void*)Ante_ctError,     AnType::getVoid(), {AnPtrType::get(AnType::getPrimitive(TT_C8))}));
         compapi.emplace("Ante_emitIR",      new CtFunc((void*)Ante_emitIR,      AnType::getVoid()));
         compapi.emplace("Ante_forget",      new CtFunc((void*)Ante_forget,      AnType::getVoid(), {AnPtrType::get(AnType::getPrimitive(TT_C8))}));
+        compapi.emplace("Ante_shuffle",     new CtFunc((void*)Ante_shuffle,     AnTypeVarType::get("'t'"), {AnTypeVarType::get("'t'"), AnTypeVarType::get("'t'"), AnTypeVarType::get("'i'")}));
+        compapi.emplace("Ante_reduce_add",  new CtFunc((void*)Ante_reduce_add,  AnTypeVarType::get("'e'"), {AnTypeVarType::get("'t'")}));
+        compapi.emplace("Ante_reduce_mul",  new CtFunc((void*)Ante_reduce_mul,  AnTypeVarType::get("'e'"), {AnTypeVarType::get("'t'")}));
+        compapi.emplace("Ante_reduce_min",  new CtFunc((void*)Ante_reduce_min,  AnTypeVarType::get("'e'"), {AnTypeVarType::get("'t'")}));
+        compapi.emplace("Ante_reduce_max",  new CtFunc((void*)Ante_reduce_max,  AnTypeVarType::get("'e'"), {AnTypeVarType::get("'t'")}));
         compapi.emplace("FuncDecl_getName", new CtFunc((void*)FuncDecl_getName, AnDataType::get("Str"), {AnDataType::get("Ante.FuncDecl")}));
     }
 
@@ -129,4 +213,10 @@ namespace ante {
         *reinterpret_cast<void**>(&resfn) = fn;
         return resfn(c, tv1, tv2);
     }
+
+    void* CtFunc::operator()(Compiler *c, TypedValue &tv1, TypedValue &tv2, TypedValue &tv3){
+        void* (*resfn)(Compiler*, TypedValue&, TypedValue&, TypedValue&) = 0;
+        *reinterpret_cast<void**>(&resfn) = fn;
+        return resfn(c, tv1, tv2, tv3);
+    }
 }
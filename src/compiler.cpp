@@ -5,20 +5,42 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Linker/Linker.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Instrumentation.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Transforms/IPO/AlwaysInliner.h"
+#include "llvm/Transforms/Vectorize.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Object/Archive.h"
+#include "llvm/Object/ObjectFile.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/ExecutionEngine/GenericValue.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
+#include <thread>
 
 #include "parser.h"
 #include "compiler.h"
 #include "types.h"
 #include "repl.h"
 #include "target.h"
+#include "timer.h"
 #include "yyparser.h"
 
+#ifdef AN_USE_LLD
+#  include "lld/Driver/Driver.h"
+#endif
+
 using namespace std;
 using namespace llvm;
 using namespace ante::parser;
@@ -91,10 +113,26 @@ bool isUnsignedTypeTag(const TypeTag tt){
 }
 
 
+/**
+ * @brief Compiles an integer literal, which is an unsigned string of decimal digits.
+ *
+ * Negative literals are parsed as a negation of the literal, so a signed literal
+ * may be one past its type's maximum value in order to write the minimum value.
+ */
 TypedValue IntLitNode::compile(Compiler *c){
-    return TypedValue(ConstantInt::get(*c->ctxt,
-                            APInt(getBitWidthOfTypeTag(type),
-                            atol(val.c_str()), isUnsignedTypeTag(type))),
+    unsigned bits = getBitWidthOfTypeTag(type);
+
+    //each decimal digit needs fewer than 4 bits
+    APInt wide{max(64u, (unsigned)val.length() * 4), val, 10};
+
+    bool overflows = isUnsignedTypeTag(type) ? wide.getActiveBits() > bits
+        : wide.ugt(APInt::getOneBitSet(wide.getBitWidth(), bits - 1));
+
+    if(overflows)
+        return c->compErr("Integer literal " + val + " is too large for its type "
+                + anTypeToColoredStr(AnType::getPrimitive(type)), loc);
+
+    return TypedValue(ConstantInt::get(*c->ctxt, wide.trunc(bits)),
             AnType::getPrimitive(type));
 }
 
@@ -187,109 +225,149 @@ void scanImports(Compiler *c, RootNode *r){
 }
 
 /**
- * @brief Compiles a Str literal that contains 1+ sites of string interpolation.
- * Concatenates
- *
- * @param sln The string literal to compile
- * @param pos The index of the first instance of ${ in the string
- *
- * @return The resulting concatenated Str
+ * @brief A piece of an interpolated string, either a Str or a number
+ * formatted directly into the resulting string's buffer
  */
-TypedValue compStrInterpolation(Compiler *c, StrLitNode *sln, int pos){
-    //get the left part of the string
-    string l = sln->val.substr(0, pos);
-
-    //make a new sub-location for it
-    yy::location lloc = mkLoc(mkPos(sln->loc.begin.filename, sln->loc.begin.line, sln->loc.begin.column),
-		                mkPos(sln->loc.end.filename,   sln->loc.end.line,   sln->loc.begin.column + pos-1));
-    auto *ls = new StrLitNode(lloc, l);
-
+struct StrPiece {
+    Value *val;
 
-    auto posEnd = sln->val.find("}", pos);
-    if(posEnd == string::npos)
-        return c->compErr("Interpolated string must have a closing bracket", sln->loc);
+    /** @brief printf format of a number, or nullptr if val is a Str */
+    const char *fmt;
 
-    //this is the ${...} part of the string without the ${ and }
-    string m = sln->val.substr(pos+2, posEnd - (pos+2));
+    /** @brief Maximum length of the formatted number */
+    size_t maxLen;
+};
 
-    string r = sln->val.substr(posEnd+1);
-    yy::location rloc = mkLoc(mkPos(sln->loc.begin.filename, sln->loc.begin.line, sln->loc.begin.column + posEnd + 1),
-							  mkPos(sln->loc.end.filename,   sln->loc.end.line,   sln->loc.end.column));
-    auto *rs = new StrLitNode(rloc, r);
+/**
+ * @brief Converts an interpolated value into a StrPiece.  Integers, floats, and
+ * characters are formatted directly while other types are cast to a Str.
+ */
+StrPiece toStrPiece(Compiler *c, TypedValue &val, Node *valNode){
+    auto tag = val.type->typeTag;
+    auto *i64 = Type::getInt64Ty(*c->ctxt);
 
-    //now that the string is separated, begin interpolation preparation
+    if(tag == TT_C8)
+        return {val.val, "%c", 1};
 
-    //lex and parse
-    auto *lex = new Lexer(sln->loc.begin.filename, m,
-            sln->loc.begin.line-1, sln->loc.begin.column + pos);
-    setLexer(lex);
-    yy::parser p{};
-    int flag = p.parse();
-    if(flag != PE_OK){ //parsing error, cannot procede
-        fputs("Syntax error in string interpolation, aborting.\n", stderr);
-        exit(flag);
+    if(isIntTypeTag(tag)){
+        //-9223372036854775808 is the longest formatted 64-bit integer
+        if(isUnsignedTypeTag(tag))
+            return {c->builder.CreateZExtOrTrunc(val.val, i64), "%llu", 20};
+        else
+            return {c->builder.CreateSExtOrTrunc(val.val, i64), "%lld", 20};
     }
 
-    RootNode *expr = parser::getRootNode();
-    TypedValue val;
-    Node *valNode = 0;
-
-    scanImports(c, expr);
-    c->scanAllDecls(expr);
-
-    //Compile main and hold onto the last value
-    for(auto &n : expr->main){
-        try{
-            val = n->compile(c);
-            valNode = n.get();
-        }catch(CtError *e){
-            delete e;
-        }
+    //Floats are printed with enough digits to be read back as the same value,
+    //9 for an f32 and 17 otherwise.  -1.2345678901234567e-308 is the longest
+    if(isFPTypeTag(tag)){
+        auto *dbl = c->builder.CreateFPExt(val.val, Type::getDoubleTy(*c->ctxt));
+        return {dbl, tag == TT_F32 ? "%.9g" : "%.17g", 24};
     }
 
-    if(!val) return val;
+    auto *strty = dyn_cast<AnDataType>(val.type);
+    if(strty and strty->name == "Str")
+        return {val.val, nullptr, 0};
 
     //if the expr is not already a string type, cast it to one
-    auto *strty = dyn_cast<AnDataType>(val.type);
-    if(!strty or strty->name != "Str"){
-		strty = AnDataType::get("Str");
-        auto fn = c->getCastFn(val.type, strty);
-
-        if(!fn){
-            delete ls;
-            delete rs;
-            return c->compErr("Cannot cast " + anTypeToColoredStr(val.type)
-                + " to Str for string interpolation.", valNode->loc);
-        }
+    strty = AnDataType::get("Str");
+    auto fn = c->getCastFn(val.type, strty);
 
-        val = TypedValue(c->builder.CreateCall(fn.val, val.val), strty);
+    if(!fn){
+        c->compErr("Cannot cast " + anTypeToColoredStr(val.type)
+            + " to Str for string interpolation.", valNode->loc);
     }
 
-    //Finally, the interpolation is done.  Now just combine the three strings
-    //get the ++_Str_Str function
-    string appendFn = "++";
-    string mangledAppendFn = "++_Str_Str";
-    auto fn = c->getFunction(appendFn, mangledAppendFn);
-    if(!fn) return c->compErr("++ overload for Str and Str not found while performing Str interpolation.  The prelude may not be imported correctly.", sln->loc);
+    return {c->builder.CreateCall(fn.val, val.val), nullptr, 0};
+}
 
-    //call the ++ function to combine the three strings
-    auto lstr = ls->compile(c);
-    auto *appendL = c->builder.CreateCall(fn.val, vector<Value*>{lstr.val, val.val});
 
-    auto rstr = rs->compile(c);
-    auto *appendR = c->builder.CreateCall(fn.val, vector<Value*>{appendL, rstr.val});
+/**
+ * @brief Compiles a Str literal that contains 1+ sites of string interpolation.
+ *
+ * The length of each piece is computed first so the result is built with a single
+ * malloc.  Each Str is then memcpy'd into the buffer and each number is formatted
+ * directly into it with snprintf rather than being converted to a Str first.
+ *
+ * @return The resulting concatenated Str
+ */
+TypedValue InterpolatedStrNode::compile(Compiler *c){
+    auto &lits = strs;
+    vector<StrPiece> pieces;
+
+    for(auto &expr : exprs){
+        auto val = expr->compile(c);
+        if(!val) return val;
+
+        pieces.push_back(toStrPiece(c, val, expr.get()));
+    }
+
+    //Each piece is written after the literal preceding it
+    Type *usz = Type::getIntNTy(*c->ctxt, AN_USZ_SIZE);
+    size_t constLen = 1; //null terminator
+    for(auto &lit : lits)
+        constLen += lit.length();
+
+    Value *len = ConstantInt::get(usz, constLen);
+    for(auto &piece : pieces){
+        if(piece.fmt)
+            len = c->builder.CreateAdd(len, ConstantInt::get(usz, piece.maxLen));
+        else
+            len = c->builder.CreateAdd(len, c->builder.CreateExtractValue(piece.val, 1));
+    }
+
+    string mallocName = "malloc", memcpyName = "memcpy", snprintfName = "snprintf";
+    auto mallocFn = c->getFunction(mallocName, mallocName);
+    auto memcpyFn = c->getFunction(memcpyName, memcpyName);
+    auto snprintfFn = c->getFunction(snprintfName, snprintfName);
+    if(!mallocFn or !memcpyFn or !snprintfFn)
+        return c->compErr("malloc, memcpy, or snprintf not found while performing Str interpolation.  The prelude may not be imported correctly.", loc);
+
+    Type *voidPtr = ((Function*)memcpyFn.val)->getFunctionType()->getFunctionParamType(0);
+    Type *c8Ptr = Type::getInt8PtrTy(*c->ctxt);
+
+    auto *buf = c->builder.CreatePointerCast(c->builder.CreateCall(mallocFn.val, len), c8Ptr);
+    Value *offset = ConstantInt::get(usz, 0);
+
+    auto append = [&](Value *src, Value *srcLen){
+        auto *dest = c->builder.CreateInBoundsGEP(buf, offset);
+        c->builder.CreateCall(memcpyFn.val, vector<Value*>{c->builder.CreatePointerCast(dest, voidPtr),
+                c->builder.CreatePointerCast(src, voidPtr), srcLen});
+        offset = c->builder.CreateAdd(offset, srcLen);
+    };
+
+    for(size_t i = 0; i < lits.size(); i++){
+        if(!lits[i].empty())
+            append(c->builder.CreateGlobalStringPtr(lits[i], "_strlit"), ConstantInt::get(usz, lits[i].length()));
+
+        if(i >= pieces.size()) break;
+        auto &piece = pieces[i];
+
+        if(!piece.fmt){
+            append(c->builder.CreateExtractValue(piece.val, 0), c->builder.CreateExtractValue(piece.val, 1));
+        }else if(piece.maxLen == 1){
+            c->builder.CreateStore(piece.val, c->builder.CreateInBoundsGEP(buf, offset));
+            offset = c->builder.CreateAdd(offset, ConstantInt::get(usz, 1));
+        }else{
+            //snprintf returns the number of characters written, not including the null terminator
+            auto *dest = c->builder.CreateInBoundsGEP(buf, offset);
+            auto *fmt = c->builder.CreateGlobalStringPtr(piece.fmt, "_fmt");
+            auto *written = c->builder.CreateCall(snprintfFn.val, vector<Value*>{dest,
+                    ConstantInt::get(usz, piece.maxLen + 1), fmt, piece.val});
+            offset = c->builder.CreateAdd(offset, c->builder.CreateZExt(written, usz));
+        }
+    }
 
-    //create the returning typenode
-    return TypedValue(appendR, strty);
+    c->builder.CreateStore(c->builder.getInt8(0), c->builder.CreateInBoundsGEP(buf, offset));
+
+    AnType *strty = AnDataType::get("Str");
+    auto *tupleTy = cast<StructType>(c->anTypeToLlvmType(strty));
+    Value *ret = c->builder.CreateInsertValue(UndefValue::get(tupleTy), buf, 0);
+    ret = c->builder.CreateInsertValue(ret, offset, 1);
+    return TypedValue(ret, strty);
 }
 
 
 TypedValue StrLitNode::compile(Compiler *c){
-    auto idx = val.find("${");
-
-    if(idx != string::npos and (idx == 0 or val.find("\\${") != idx - 1))
-        return compStrInterpolation(c, this, idx);
-
     AnType *strty = AnDataType::get("Str");
 
     auto *ptr = c->builder.CreateGlobalStringPtr(val, "_strlit");
@@ -477,16 +555,133 @@ TypedValue WhileNode::compile(Compiler *c){
 }
 
 
-TypedValue ForNode::compile(Compiler *c){
+/*
+ *  Returns true if a for loop over a value of type t is compiled by
+ *  compCountedFor instead of through the Iterator trait.
+ */
+bool isCountedLoopType(AnType *t){
+    if(auto *arr = dyn_cast<AnArrayType>(t))
+        return arr->len > 0;
+
+    auto *dt = dyn_cast<AnDataType>(t);
+    return dt and (dt->name == "Range" or dt->name == "VecIter");
+}
+
+/*
+ *  Compiles a for loop over a Range, a fixed-size array, or the VecIter of a Vec
+ *  as a counted loop with a single phi for its induction variable.  Unlike the
+ *  Iterator protocol this needs no calls or stack-allocated iterator, so
+ *  the loop is in a form llvm can compute the trip count of and vectorize.
+ */
+TypedValue compCountedFor(Compiler *c, ForNode *fn, TypedValue &rangev){
     Function *f = c->builder.GetInsertBlock()->getParent();
+    BasicBlock *preheader = c->builder.GetInsertBlock();
     BasicBlock *cond  = BasicBlock::Create(*c->ctxt, "for_cond", f);
     BasicBlock *begin = BasicBlock::Create(*c->ctxt, "for", f);
-    BasicBlock *incr = BasicBlock::Create(*c->ctxt, "for_incr", f);
+    BasicBlock *incr  = BasicBlock::Create(*c->ctxt, "for_incr", f);
     BasicBlock *end   = BasicBlock::Create(*c->ctxt, "end_for", f);
 
+    //the loop counts from start to last, inclusive for Ranges and exclusive otherwise.
+    //If elems is set the loop variable is the element at each index rather than the index
+    Value *start, *last, *step = nullptr, *elems = nullptr;
+    AnType *elemTy;
+
+    if(auto *arr = dyn_cast<AnArrayType>(rangev.type)){
+        Value *ptr;
+        if(LoadInst *li = dyn_cast<LoadInst>(rangev.val)){
+            ptr = li->getPointerOperand();
+        }else{
+            ptr = c->builder.CreateAlloca(rangev.getType());
+            c->builder.CreateStore(rangev.val, ptr);
+        }
+        elems = c->builder.CreateConstInBoundsGEP2_64(ptr, 0, 0);
+        start = c->builder.getInt64(0);
+        last = c->builder.getInt64(arr->len);
+        elemTy = arr->extTy;
+    }else{
+        auto *dt = (AnDataType*)rangev.type;
+        if(dt->name == "Range"){
+            start = c->builder.CreateExtractValue(rangev.val, 0);
+            last = c->builder.CreateExtractValue(rangev.val, 1);
+            step = c->builder.CreateExtractValue(rangev.val, 2);
+            elemTy = dt->extTys[0];
+        }else{
+            elems = c->builder.CreateExtractValue(rangev.val, 0);
+            start = c->builder.CreateExtractValue(rangev.val, 1);
+            last = c->builder.CreateExtractValue(rangev.val, 2);
+            elemTy = ((AnPtrType*)dt->extTys[0])->extTy;
+        }
+    }
+
+    //A Range's step may be negative, in which case it counts down to last
+    Value *countsUp = step ? c->builder.CreateICmpSGT(step, ConstantInt::get(step->getType(), 0)) : nullptr;
+
+    c->builder.CreateBr(cond);
+    c->builder.SetInsertPoint(cond);
+
+    PHINode *i = c->builder.CreatePHI(start->getType(), 2, "i");
+    i->addIncoming(start, preheader);
 
+    Value *inBounds;
+    if(step){
+        inBounds = c->builder.CreateSelect(countsUp, c->builder.CreateICmpSLE(i, last),
+                c->builder.CreateICmpSGE(i, last));
+    }else{
+        inBounds = c->builder.CreateICmpULT(i, last);
+    }
+
+    c->builder.CreateCondBr(inBounds, begin, end);
+    c->builder.SetInsertPoint(begin);
+
+    TypedValue elem = elems ? TypedValue(c->builder.CreateLoad(c->builder.CreateInBoundsGEP(elems, i)), elemTy)
+                            : TypedValue(i, elemTy);
+
+    auto *elem_var = new Variable(fn->var, elem, c->scope);
+    c->stoVar(fn->var, elem_var);
+
+    c->compCtxt->breakLabels->push_back(end);
+    c->compCtxt->continueLabels->push_back(incr);
+
+    TypedValue val;
+    try{
+        val = fn->child->compile(c);
+    }catch(CtError *e){
+        c->compCtxt->breakLabels->pop_back();
+        c->compCtxt->continueLabels->pop_back();
+        throw e;
+    }
+
+    c->compCtxt->breakLabels->pop_back();
+    c->compCtxt->continueLabels->pop_back();
+
+    if(!val) return val;
+    if(!dyn_cast<ReturnInst>(val.val) and !dyn_cast<BranchInst>(val.val)){
+        c->builder.CreateBr(incr);
+        c->builder.SetInsertPoint(incr);
+
+        if(step){
+            //stop once last is reached rather than stepping past it in case last + step overflows
+            Value *atLast = c->builder.CreateICmpEQ(i, last);
+            i->addIncoming(c->builder.CreateAdd(i, step), incr);
+            c->builder.CreateCondBr(atLast, end, cond);
+        }else{
+            i->addIncoming(c->builder.CreateNUWAdd(i, ConstantInt::get(i->getType(), 1)), incr);
+            c->builder.CreateBr(cond);
+        }
+    }
+
+    c->builder.SetInsertPoint(end);
+    return c->getVoidLiteral();
+}
+
+
+TypedValue ForNode::compile(Compiler *c){
     auto rangev = range->compile(c);
 
+    //Ranges, arrays, and Vecs once converted to iterators are compiled as counted loops
+    if(isCountedLoopType(rangev.type))
+        return compCountedFor(c, this, rangev);
+
     //check if the range expression is its own iterator and thus implements Iterator
     //If it does not, see if it implements Iterable by attempting to call into_iter on it
     auto *dt = dyn_cast<AnDataType>(rangev.type);
@@ -499,8 +694,16 @@ TypedValue ForNode::compile(Compiler *c){
                 " to be used in a for loop", range->loc);
 
         rangev = res;
+        if(isCountedLoopType(rangev.type))
+            return compCountedFor(c, this, rangev);
     }
 
+    Function *f = c->builder.GetInsertBlock()->getParent();
+    BasicBlock *cond  = BasicBlock::Create(*c->ctxt, "for_cond", f);
+    BasicBlock *begin = BasicBlock::Create(*c->ctxt, "for", f);
+    BasicBlock *incr = BasicBlock::Create(*c->ctxt, "for_incr", f);
+    BasicBlock *end   = BasicBlock::Create(*c->ctxt, "end_for", f);
+
     //by this point, rangev now properly stores the range information, so store it on the stack and insert calls to
     //unwrap, has_next, and next at the beginning, beginning, and end of the loop respectively.
     Value *alloca = c->builder.CreateAlloca(rangev.getType());
@@ -1569,6 +1772,7 @@ void Compiler::importFile(const char *fName, Node *locNode){
         mergedCompUnits->import(import);
     }else{
         //module not found; create new Compiler instance to compile it
+        TraceEvent trace{"importFile", fName};
         auto c = unique_ptr<Compiler>(new Compiler(fName, true, ctxt));
         c->ctxt = ctxt;
         c->compilePrelude();
@@ -1660,6 +1864,7 @@ void compileAll(Compiler *c, vector<T> &v){
 
 
 void Compiler::scanAllDecls(RootNode *root){
+    ScopedTimer timer{"scanAllDecls", fileName};
     auto *n = root ? root : ast.get();
 	
     for (auto& f : n->types) {
@@ -1756,12 +1961,18 @@ void Compiler::compile(){
     auto *mainFn = createMainFn();
     compilePrelude();
 
-    ast->compile(this);
+    {
+        ScopedTimer timer{"RootNode::compile", fileName};
+        ast->compile(this);
+    }
 
     //always return 0
     builder.CreateRet(ConstantInt::get(*ctxt, APInt(32, 0)));
-    if(!errFlag)
+    if(!errFlag && !deferFnPasses){
+        ScopedTimer timer{"function passes", fileName};
+        TraceEvent trace{"passes", mainFn->getName().str()};
         passManager->run(*mainFn);
+    }
 
     //flag this module as compiled.
     compiled = true;
@@ -1782,8 +1993,37 @@ void Compiler::compileNative(){
     //this file will become the obj file before linking
     string objFile = outFile + ".o";
 
-    if(!compileIRtoObj(module.get(), objFile)){
-        linkObj(objFile, outFile);
+    applyProfile();
+    runModulePasses();
+
+    string otherInputs = profileGenerate ? " " AN_PROFILE_RT : "";
+
+    //the thread pool behind parallel_for is only linked in when it is used
+    if(module->getFunction("ante_parallel_for"))
+        otherInputs += " " AN_RUNTIME " -lpthread";
+
+    if(lto){
+        otherInputs += linkTimeOptimize();
+    }else{
+        for(auto &f : linkFiles)
+            otherInputs += " " + f;
+    }
+
+    if(codegenThreads > 1){
+        vector<string> objFiles;
+        if(!compileIRtoObjParallel(module.get(), outFile, codegenThreads, objFiles)){
+            string objs = "";
+            for(auto &f : objFiles)
+                objs += f + " ";
+
+            linkObj(objs + otherInputs, outFile);
+        }
+
+        for(auto &f : objFiles)
+            remove(f.c_str());
+
+    }else if(!compileIRtoObj(module.get(), objFile)){
+        linkObj(objFile + otherInputs, outFile);
         remove(objFile.c_str());
     }
 }
@@ -1794,10 +2034,148 @@ int Compiler::compileObj(string &outName){
     string modName = removeFileExt(fileName);
     string objFile = outName.length() > 0 ? outName : modName + ".o";
 
+    applyProfile();
+    runModulePasses();
+
+    if(lto)
+        return compileIRtoBitcode(module.get(), objFile);
+
     return compileIRtoObj(module.get(), objFile);
 }
 
 
+void Compiler::applyProfile(){
+    if(!deferFnPasses) return;
+
+    ScopedTimer timer{"profile passes", fileName};
+    legacy::PassManager pm;
+    if(profileGenerate){
+        pm.add(createPGOInstrumentationGenLegacyPass());
+        pm.add(createInstrProfilingLegacyPass());
+    }else{
+        pm.add(createPGOInstrumentationUseLegacyPass(profileUse));
+    }
+    pm.run(*module);
+
+    //now that the branch weights and entry counts are known, the
+    //per-function optimizations that were skipped in compFn can be run
+    if(!errFlag){
+        for(auto &f : *module)
+            if(!f.isDeclaration())
+                passManager->run(f);
+    }
+
+    deferFnPasses = false;
+}
+
+
+void addVectorizePasses(legacy::PassManagerBase &pm);
+
+void Compiler::runModulePasses(){
+    if(errFlag || optLvl < 2 || modulePassesRun)
+        return;
+
+    modulePassesRun = true;
+    ScopedTimer timer{"module passes", fileName};
+    legacy::PassManager pm;
+
+    //Functions marked ![inline], including the Iterator methods of the prelude, are only
+    //inlined here, so loops are vectorized once over the whole module after the calls in
+    //their headers are gone rather than as each function is compiled.
+    pm.add(createAlwaysInlinerLegacyPass());
+    addVectorizePasses(pm);
+
+    if(mergeFunctions)
+        pm.add(createMergeFunctionsPass());
+
+    pm.run(*module);
+}
+
+
+/*
+ *  Adds the name of each symbol used but not defined by the object
+ *  file or archive bin to syms
+ */
+void addUndefinedSymbols(object::Binary *bin, StringSet<> &syms){
+    if(auto *obj = dyn_cast<object::ObjectFile>(bin)){
+        for(auto &sym : obj->symbols()){
+            if(!(sym.getFlags() & object::SymbolRef::SF_Undefined))
+                continue;
+
+            if(auto name = sym.getName())
+                syms.insert(*name);
+            else
+                consumeError(name.takeError());
+        }
+    }else if(auto *archive = dyn_cast<object::Archive>(bin)){
+        Error err = Error::success();
+        for(auto &child : archive->children(err)){
+            if(auto member = child.getAsBinary())
+                addUndefinedSymbols(member->get(), syms);
+            else
+                consumeError(member.takeError());
+        }
+        consumeError(move(err));
+    }
+}
+
+
+string Compiler::linkTimeOptimize(){
+    ScopedTimer timer{"link-time optimization", fileName};
+    string otherInputs = "";
+    Linker linker{*module};
+
+    //symbols that objects left for the system linker use from this module
+    StringSet<> externSyms;
+
+    for(auto &file : linkFiles){
+        SMDiagnostic diag;
+        unique_ptr<llvm::Module> bc = parseIRFile(file, diag, *ctxt);
+
+        //not bitcode, leave it for the system linker
+        if(!bc){
+            otherInputs += " " + file;
+
+            if(auto bin = object::createBinary(file))
+                addUndefinedSymbols(bin->getBinary(), externSyms);
+            else
+                consumeError(bin.takeError());
+            continue;
+        }
+
+        //Each module compiles its own copy of every prelude function it uses,
+        //so any definition already present is dropped in favor of the existing one.
+        for(auto &f : *bc){
+            auto *existing = module->getFunction(f.getName());
+            if(!f.isDeclaration() && f.hasExternalLinkage() && existing && !existing->isDeclaration())
+                f.deleteBody();
+        }
+
+        if(linker.linkInModule(move(bc))){
+            cerr << "Error when linking bitcode file " << file << endl;
+            errFlag = true;
+        }
+    }
+
+    //Only main, the init functions of libraries, and the symbols used by
+    //objects that are not bitcode need to be visible.  Everything else can
+    //be internalized and freely inlined or removed.
+    legacy::PassManager pm;
+    pm.add(createInternalizePass([&](const GlobalValue &gv){
+        auto name = gv.getName();
+        return name == "main" || name.startswith("init_") || externSyms.count(name);
+    }));
+
+    PassManagerBuilder pmb;
+    pmb.OptLevel = optLvl;
+    pmb.Inliner = createFunctionInliningPass(optLvl, 0, false);
+    pmb.populateLTOPassManager(pm);
+
+    pm.run(*module);
+    return otherInputs;
+}
+
+
 const Target* getTarget(){
     LLVMInitializeNativeTarget();
     LLVMInitializeNativeAsmPrinter();
@@ -1837,7 +2215,50 @@ TargetMachine* getTargetMachine(){
 }
 
 
+void defineSerialParallelFor(llvm::Module *mod){
+    Function *f = mod->getFunction("ante_parallel_for");
+    if(!f or !f->isDeclaration()) return;
+
+    auto args = f->arg_begin();
+    Value *start = &*args++;
+    Value *last = &*args++;
+    Value *step = &*args++;
+    Value *body = &*args;
+
+    LLVMContext &ctxt = mod->getContext();
+    BasicBlock *entry = BasicBlock::Create(ctxt, "entry", f);
+    BasicBlock *cond  = BasicBlock::Create(ctxt, "for_cond", f);
+    BasicBlock *loop  = BasicBlock::Create(ctxt, "for", f);
+    BasicBlock *end   = BasicBlock::Create(ctxt, "end_for", f);
+    IRBuilder<> builder{entry};
+
+    Value *zero = builder.getInt32(0);
+    Value *countsUp = builder.CreateICmpSGT(step, zero);
+    Value *countsDown = builder.CreateICmpSLT(step, zero);
+    builder.CreateBr(cond);
+
+    //the same loop as runtime.c, so a step of 0 runs start only if it equals last
+    builder.SetInsertPoint(cond);
+    PHINode *i = builder.CreatePHI(start->getType(), 2, "i");
+    i->addIncoming(start, entry);
+
+    Value *inBounds = builder.CreateSelect(countsUp, builder.CreateICmpSLE(i, last),
+            builder.CreateSelect(countsDown, builder.CreateICmpSGE(i, last), builder.CreateICmpEQ(i, last)));
+    builder.CreateCondBr(inBounds, loop, end);
+
+    builder.SetInsertPoint(loop);
+    builder.CreateCall(body, {i});
+    i->addIncoming(builder.CreateAdd(i, step), loop);
+    builder.CreateCondBr(builder.CreateICmpEQ(i, last), end, cond);
+
+    builder.SetInsertPoint(end);
+    builder.CreateRetVoid();
+}
+
+
 void Compiler::jitFunction(Function *f){
+    defineSerialParallelFor(module.get());
+
     if(!jit.get()){
         auto* eBuilder = new EngineBuilder(unique_ptr<llvm::Module>(module.get()));
 
@@ -1859,9 +2280,12 @@ void Compiler::jitFunction(Function *f){
 }
 
 
-int Compiler::compileIRtoObj(llvm::Module *mod, string outFile){
-    auto *tm = getTargetMachine();
-
+/**
+ * @brief Emits an obj file for the given module with an existing TargetMachine
+ *
+ * @return 0 on success
+ */
+int emitObjFile(TargetMachine *tm, llvm::Module *mod, string outFile){
     std::error_code errCode;
     raw_fd_ostream out{outFile, errCode, sys::fs::OpenFlags::F_RW};
 
@@ -1880,19 +2304,144 @@ int Compiler::compileIRtoObj(llvm::Module *mod, string outFile){
 	if (out.has_error())
 		cerr << "Error when compiling to object: " << errCode << endl;
 
+    return res;
+}
+
+
+int Compiler::compileIRtoObj(llvm::Module *mod, string outFile){
+    ScopedTimer timer{"compileIRtoObj", fileName};
+    auto *tm = getTargetMachine();
+    int res = emitObjFile(tm, mod, outFile);
     delete tm;
     return res;
 }
 
 
+int Compiler::compileIRtoObjParallel(llvm::Module *mod, string outFile, unsigned int partitions,
+        vector<string> &objFiles){
+    ScopedTimer timer{"compileIRtoObj", fileName};
+
+    //SplitModule consumes the module it is given, so split a copy to
+    //leave this module usable by the jit and -emit-llvm
+    vector<SmallString<0>> bitcode;
+    SplitModule(CloneModule(mod), partitions, [&](unique_ptr<llvm::Module> partition){
+        bitcode.emplace_back();
+        raw_svector_ostream os{bitcode.back()};
+        WriteBitcodeToFile(partition.get(), os);
+    });
+
+    //TargetMachines are created up front as target initialization is not thread-safe
+    vector<unique_ptr<TargetMachine>> tms;
+    for(size_t i = 0; i < bitcode.size(); i++){
+        tms.emplace_back(getTargetMachine());
+        objFiles.push_back(outFile + "." + to_string(i) + ".o");
+    }
+
+    vector<int> results(bitcode.size(), 0);
+    vector<thread> threads;
+
+    for(size_t i = 0; i < bitcode.size(); i++){
+        threads.emplace_back([&, i]{
+            LLVMContext partitionCtxt;
+            MemoryBufferRef buf{StringRef(bitcode[i].data(), bitcode[i].size()), objFiles[i]};
+
+            auto partition = parseBitcodeFile(buf, partitionCtxt);
+            if(!partition){
+                logAllUnhandledErrors(partition.takeError(), llvm::errs(), "Error when loading partition: ");
+                results[i] = 1;
+                return;
+            }
+
+            results[i] = emitObjFile(tms[i].get(), partition->get(), objFiles[i]);
+        });
+    }
+
+    int res = 0;
+    for(size_t i = 0; i < threads.size(); i++){
+        threads[i].join();
+        res |= results[i];
+    }
+    return res;
+}
+
+
+int Compiler::compileIRtoBitcode(llvm::Module *mod, string outFile){
+    std::error_code errCode;
+    raw_fd_ostream out{outFile, errCode, sys::fs::OpenFlags::F_None};
+
+    if(errCode){
+        cerr << "Error when opening file " << outFile << ": " << errCode.message() << endl;
+        return 1;
+    }
+
+    WriteBitcodeToFile(mod, out);
+    out.flush();
+    return out.has_error();
+}
+
+
+#ifdef AN_USE_LLD
+/**
+ * @brief Links the given object files with lld's library interface,
+ * avoiding the fork/exec of the gcc driver, collect2, and ld.
+ *
+ * The crt objects and libc are located using AN_CRT_DIR and
+ * AN_GCC_LIB_DIR which are set by the Makefile when building with USE_LLD.
+ *
+ * @return 0 on success
+ */
+int lldLink(string inFiles, string outFile, bool dynamic){
+    vector<string> args = {"ld.lld", "-o", outFile,
+        "-L" AN_CRT_DIR, "-L" AN_GCC_LIB_DIR,
+        AN_CRT_DIR "/crt1.o", AN_CRT_DIR "/crti.o"};
+
+    if(dynamic){
+        args.push_back("-dynamic-linker");
+        args.push_back(AN_DYNAMIC_LINKER);
+        args.push_back(AN_GCC_LIB_DIR "/crtbegin.o");
+    }else{
+        args.push_back("-static");
+        args.push_back(AN_GCC_LIB_DIR "/crtbeginT.o");
+    }
+
+    istringstream files{inFiles};
+    string file;
+    while(files >> file)
+        args.push_back(file);
+
+    if(dynamic){
+        args.insert(args.end(), {"-lc", "-lgcc", "--as-needed", "-lgcc_s", "--no-as-needed"});
+    }else{
+        args.insert(args.end(), {"--start-group", "-lc", "-lgcc", "-lgcc_eh", "--end-group"});
+    }
+
+    args.push_back(AN_GCC_LIB_DIR "/crtend.o");
+    args.push_back(AN_CRT_DIR "/crtn.o");
+
+    vector<const char*> argv;
+    for(auto &arg : args)
+        argv.push_back(arg.c_str());
+
+    return lld::elf::link(argv, false, llvm::errs()) ? 0 : 1;
+}
+#endif
+
+
 int Compiler::linkObj(string inFiles, string outFile){
-    string cmd = AN_LINKER " " + inFiles + " -static -o " + outFile;
+    ScopedTimer timer{"linkObj", fileName};
+#ifdef AN_USE_LLD
+    if(!externalLinker)
+        return lldLink(inFiles, outFile, dynamicLink);
+#endif
+
+    string cmd = AN_LINKER " " + inFiles + (dynamicLink ? "" : " -static") + " -o " + outFile;
     return system(cmd.c_str());
 }
 
 
 void Compiler::emitIR(){
     if(!compiled) compile();
+    runModulePasses();
     if(errFlag) puts("Partially compiled module: \n");
     module->print(llvm::errs(), nullptr);
 }
@@ -1966,6 +2515,7 @@ void Compiler::exitScope(){
             Type *vPtr = freeFn->getFunctionType()->getFunctionParamType(0);
             val = builder.CreatePointerCast(val, vPtr);
             builder.CreateCall(freeFn, val);
+            stats.exitScopeFrees++;
         }
     }
 
@@ -2031,6 +2581,33 @@ inline void Compiler::stoType(AnDataType *dt, string &typeName){
     mergedCompUnits->userTypes[typeName] = dt;
 }
 
+/**
+ * @brief Returns a TargetMachine for the native target shared by every pass
+ * manager so the vectorizers know the width of the target's vector registers.
+ */
+TargetMachine* getPassTargetMachine(){
+    static unique_ptr<TargetMachine> tm{getTargetMachine()};
+    return tm.get();
+}
+
+/**
+ * @brief Adds the passes that put loops into a canonical form and vectorize them.
+ *
+ * Loops are rotated and their induction variables simplified first, otherwise
+ * the loop vectorizer cannot compute their trip counts.
+ */
+void addVectorizePasses(legacy::PassManagerBase &pm){
+    pm.add(createTargetTransformInfoWrapperPass(getPassTargetMachine()->getTargetIRAnalysis()));
+    pm.add(createPromoteMemoryToRegisterPass());
+    pm.add(createCFGSimplificationPass());
+    pm.add(createLoopRotatePass());
+    pm.add(createLICMPass());
+    pm.add(createIndVarSimplifyPass());
+    pm.add(createLoopVectorizePass());
+    pm.add(createSLPVectorizerPass());
+    pm.add(createCFGSimplificationPass());
+}
+
 /**
  * @brief Creates a pass manager and fills it with passes.
  *
@@ -2090,7 +2667,8 @@ Compiler::Compiler(const char *_fileName, bool lib, shared_ptr<LLVMContext> llvm
         isJIT(false),
         fileName(_fileName? _fileName : "(stdin)"),
         funcPrefix(""),
-        scope(0), optLvl(2), fnScope(1){
+        scope(0), optLvl(2), fnScope(1), lto(false), dynamicLink(false), externalLinker(false), codegenThreads(1),
+        profileGenerate(false), deferFnPasses(false), mergeFunctions(false), modulePassesRun(false){
 
     //The lexer stores the fileName in the loc field of all Nodes. The fileName is copied
     //to let Node's outlive the Compiler they were made in, ensuring they work with imports.
@@ -2099,7 +2677,13 @@ Compiler::Compiler(const char *_fileName, bool lib, shared_ptr<LLVMContext> llvm
         fileNames.emplace_back(fileName_cpy);
         setLexer(new Lexer(fileName_cpy));
         yy::parser p{};
-        int flag = p.parse();
+        int flag;
+        {
+            //lexing is done on demand by the parser so it is timed as part of this phase.
+            //Timing each token separately would cost two clock reads per token.
+            ScopedTimer timer{"lex and parse", fileName};
+            flag = p.parse();
+        }
         if(flag != PE_OK){ //parsing error, cannot procede
             //print out remaining errors
             int tok;
@@ -2156,7 +2740,8 @@ Compiler::Compiler(Compiler *c, Node *root, string modName, bool lib) :
         fileName(c->fileName),
         outFile(modName),
         funcPrefix(""),
-        scope(0), optLvl(2), fnScope(1){
+        scope(0), optLvl(2), fnScope(1), lto(false), dynamicLink(false), externalLinker(false), codegenThreads(1),
+        profileGenerate(false), deferFnPasses(false), mergeFunctions(false), modulePassesRun(false){
 
     allMergedCompUnits.emplace_back(mergedCompUnits);
 
@@ -2184,6 +2769,20 @@ void Compiler::processArgs(CompilerArgs *args){
         out = outFile;
     }
 
+    if(args->hasArg(Args::ProfileGenerate)){
+        profileGenerate = true;
+        deferFnPasses = true;
+    }
+
+    if(auto *arg = args->getArg(Args::ProfileUse)){
+        if(profileGenerate){
+            cerr << "-fprofile-generate and -fprofile-use cannot be used together\n";
+            exit(1);
+        }
+        profileUse = arg->arg;
+        deferFnPasses = true;
+    }
+
     if(auto *arg = args->getArg(Args::OptLvl)){
         if(arg->arg == "0") optLvl = 0;
         else if(arg->arg == "1") optLvl = 1;
@@ -2195,6 +2794,28 @@ void Compiler::processArgs(CompilerArgs *args){
     }
 
 
+    if(args->hasArg(Args::LTO))
+        lto = true;
+
+    linkFiles = args->linkFiles;
+
+    if(auto *arg = args->getArg(Args::CodegenThreads)){
+        int threads = atoi(arg->arg.c_str());
+        codegenThreads = threads > 1 ? threads : 1;
+    }
+
+    if(auto *arg = args->getArg(Args::Incremental))
+        cacheDir = arg->arg;
+
+    if(args->hasArg(Args::MergeFunctions))
+        mergeFunctions = true;
+
+    if(args->hasArg(Args::DynamicLink))
+        dynamicLink = true;
+
+    if(args->hasArg(Args::ExternalLinker))
+        externalLinker = true;
+
     //make sure even non-called functions are included in the binary
     //if the -lib flag is set
     if(args->hasArg(Args::Lib)){
@@ -0,0 +1,337 @@
+/*
+ *      fncache.cpp
+ * Provides the on-disk cache used by -incremental to reuse
+ * the optimized bodies of unchanged functions across builds.
+ */
+#include "fncache.h"
+#include "types.h"
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/TypeFinder.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//Bump whenever the format of the cache or the code generated for a given AST changes
+#define AN_FNCACHE_VERSION "1"
+
+using namespace std;
+using namespace llvm;
+using namespace ante::parser;
+
+namespace ante {
+
+//Lines of each source file, loaded on the first function hashed from each file
+llvm::StringMap<vector<string>> sourceLines;
+
+size_t getIndentation(const string &line){
+    size_t i = 0;
+    while(i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+        i++;
+    return i;
+}
+
+bool isBlank(const string &line){
+    return getIndentation(line) == line.size();
+}
+
+/*
+ *  Returns the source text of a function.  Ante is whitespace-sensitive so the
+ *  function ends at the first non-blank line indented no further than its declaration.
+ *  Any modifiers such as !inline on the lines directly above the declaration are included.
+ */
+string getFnSource(FuncDeclNode *fdn){
+    auto *fileName = fdn->loc.begin.filename;
+    if(!fileName) return "";
+
+    auto it = sourceLines.find(*fileName);
+    if(it == sourceLines.end()){
+        ifstream file{*fileName};
+        if(!file) return "";
+
+        vector<string> lines;
+        string line;
+        while(getline(file, line))
+            lines.push_back(line);
+
+        it = sourceLines.try_emplace(*fileName, move(lines)).first;
+    }
+
+    auto &lines = it->getValue();
+    size_t declLine = fdn->loc.begin.line;
+    if(declLine == 0 || declLine > lines.size()) return "";
+
+    size_t begin = declLine - 1;
+    size_t indent = getIndentation(lines[begin]);
+
+    while(begin > 0 && getIndentation(lines[begin-1]) == indent && lines[begin-1][indent] == '!')
+        begin--;
+
+    size_t end = declLine;
+    while(end < lines.size() && (isBlank(lines[end]) || getIndentation(lines[end]) > indent))
+        end++;
+
+    while(end > declLine && isBlank(lines[end-1]))
+        end--;
+
+    string src = "";
+    for(size_t i = begin; i < end; i++)
+        src += lines[i] + '\n';
+    return src;
+}
+
+
+string getFnCacheKey(Compiler *c, FuncDecl *fd, AnType *fnTy){
+    //lambdas have no name they could be found by again
+    if(fd->mangledName.empty()) return "";
+
+    string src = getFnSource(fd->fdn.get());
+    if(src.empty()) return "";
+
+    MD5 hash;
+    auto add = [&](StringRef s){
+        hash.update(s);
+        hash.update(StringRef("\0", 1));
+    };
+
+    add(AN_FNCACHE_VERSION);
+    add(src);
+    add(fd->mangledName);
+    add(anTypeToStr(fnTy));
+    add(to_string(c->optLvl));
+
+    for(auto &binding : fd->obj_bindings){
+        add(binding.first);
+        add(anTypeToStr(binding.second));
+    }
+
+    MD5::MD5Result res;
+    hash.final(res);
+
+    SmallString<32> key;
+    MD5::stringifyResult(res, key);
+    return key.str().str();
+}
+
+
+string llvmTypeToStr(Type *t){
+    string s;
+    raw_string_ostream os{s};
+    t->print(os);
+    return os.str();
+}
+
+string structBodyToStr(StructType *st){
+    string s = st->isPacked() ? "<{" : "{";
+    for(auto *elem : st->elements())
+        s += llvmTypeToStr(elem) + ",";
+    return s + (st->isPacked() ? "}>" : "}");
+}
+
+/*
+ *  Returns the mangled names of every declared overload of a function so
+ *  cached callers are invalidated if an overload is added or removed and
+ *  overload resolution could have a different result.
+ */
+string getOverloadsStr(Compiler *c, string &baseName){
+    vector<string> overloads;
+    for(auto &fd : c->getFunctionList(baseName)){
+        //skip instances of generic functions
+        if(!fd->type)
+            overloads.push_back(fd->mangledName);
+    }
+
+    std::sort(overloads.begin(), overloads.end());
+
+    string ret = "";
+    for(auto &o : overloads)
+        ret += o + ";";
+    return ret;
+}
+
+/*
+ *  Checks that a callee is still declared with the same signature and
+ *  set of overloads as when its caller was cached.  Compiles the callee
+ *  if it has not yet been compiled.
+ */
+bool calleeUnchanged(Compiler *c, string &baseName, string &mangledName, string &overloads, string &sig){
+    if(getOverloadsStr(c, baseName) != overloads)
+        return false;
+
+    try{
+        auto tv = c->getFunction(baseName, mangledName);
+        return !!tv && anTypeToStr(tv.type) == sig;
+    }catch(CtError *e){
+        delete e;
+        return false;
+    }
+}
+
+vector<string> splitTabs(string &line){
+    vector<string> fields;
+    string field;
+    istringstream ss{line};
+    while(getline(ss, field, '\t'))
+        fields.push_back(field);
+    return fields;
+}
+
+
+Function* loadCachedFn(Compiler *c, FuncDecl *fd, string &key){
+    string entry = c->cacheDir + "/" + key;
+
+    ifstream deps{entry + ".deps"};
+    if(!deps) return nullptr;
+
+    string line;
+    while(getline(deps, line)){
+        auto fields = splitTabs(line);
+
+        if(fields.size() == 5 && fields[0] == "fn"){
+            if(!calleeUnchanged(c, fields[1], fields[2], fields[3], fields[4]))
+                return nullptr;
+
+        }else if(fields.size() == 3 && fields[0] == "var"){
+            auto *gv = c->module->getNamedGlobal(fields[1]);
+            if(!gv || llvmTypeToStr(gv->getValueType()) != fields[2])
+                return nullptr;
+
+        }else if(fields.size() == 3 && fields[0] == "ty"){
+            auto *st = c->module->getTypeByName(fields[1]);
+            if(!st || structBodyToStr(st) != fields[2])
+                return nullptr;
+
+        }else{
+            return nullptr;
+        }
+    }
+
+    auto buf = MemoryBuffer::getFile(entry + ".bc");
+    if(!buf) return nullptr;
+
+    auto cached = parseBitcodeFile((*buf)->getMemBufferRef(), *c->ctxt);
+    if(!cached){
+        consumeError(cached.takeError());
+        return nullptr;
+    }
+
+    //The declaration of this function created by compFn is replaced with
+    //the cached definition and the declarations of its callees are resolved
+    if(Linker::linkModules(*c->module, move(*cached))){
+        cerr << "Error when linking cached function " << fd->mangledName << endl;
+        return nullptr;
+    }
+
+    return c->module->getFunction(fd->mangledName);
+}
+
+
+/*
+ *  Collects each global referenced by the given value, looking
+ *  through any constant expressions such as geps and bitcasts
+ */
+void collectGlobals(Value *v, SmallPtrSetImpl<GlobalValue*> &globals){
+    if(auto *gv = dyn_cast<GlobalValue>(v)){
+        globals.insert(gv);
+    }else if(auto *cnst = dyn_cast<Constant>(v)){
+        for(auto &op : cnst->operands())
+            collectGlobals(op, globals);
+    }
+}
+
+
+void storeCachedFn(Compiler *c, FuncDecl *fd, Function *f, string &key){
+    SmallPtrSet<GlobalValue*, 16> globals;
+    for(auto &bb : *f)
+        for(auto &inst : bb)
+            for(auto &op : inst.operands())
+                collectGlobals(op, globals);
+
+    //The cached module contains only this function, declarations of
+    //its callees, and copies of the constants it uses
+    auto mod = llvm::make_unique<llvm::Module>(fd->mangledName, *c->ctxt);
+    mod->setDataLayout(c->module->getDataLayout());
+    mod->setTargetTriple(c->module->getTargetTriple());
+
+    ValueToValueMapTy vmap;
+    string fnDeps = "", varDeps = "", tyDeps = "";
+
+    for(auto *gv : globals){
+        if(gv == f) continue;
+
+        if(auto *callee = dyn_cast<Function>(gv)){
+            if(!callee->isIntrinsic()){
+                //lambdas are never given a FuncDecl that can be found by name
+                auto it = c->compiledFns.find(callee->getName());
+                if(it == c->compiledFns.end()) return;
+
+                auto *cfd = it->getValue();
+                fnDeps += "fn\t" + cfd->getName() + "\t" + cfd->mangledName + "\t"
+                    + getOverloadsStr(c, cfd->getName()) + "\t" + anTypeToStr(cfd->tv.type) + "\n";
+            }
+
+            vmap[callee] = Function::Create(callee->getFunctionType(), GlobalValue::ExternalLinkage, callee->getName(), mod.get());
+
+        }else if(auto *var = dyn_cast<GlobalVariable>(gv)){
+            //a copy of a mutable global local to this module would not share its state
+            if(var->hasLocalLinkage() && !var->isConstant()) return;
+
+            auto *cpy = new GlobalVariable(*mod, var->getValueType(), var->isConstant(), var->getLinkage(), nullptr, var->getName());
+            cpy->copyAttributesFrom(var);
+            vmap[var] = cpy;
+
+            if(!var->hasLocalLinkage())
+                varDeps += "var\t" + var->getName().str() + "\t" + llvmTypeToStr(var->getValueType()) + "\n";
+        }else{
+            return;
+        }
+    }
+
+    //initializers of local constants like string literals are copied once every global is mapped
+    for(auto *gv : globals){
+        auto *var = dyn_cast<GlobalVariable>(gv);
+        if(var && var->hasLocalLinkage() && var->hasInitializer())
+            cast<GlobalVariable>(vmap[var])->setInitializer(MapValue(var->getInitializer(), vmap));
+    }
+
+    auto *cpy = Function::Create(f->getFunctionType(), f->getLinkage(), f->getName(), mod.get());
+    cpy->copyAttributesFrom(f);
+    vmap[f] = cpy;
+
+    auto cpyArg = cpy->arg_begin();
+    for(auto &arg : f->args()){
+        cpyArg->setName(arg.getName());
+        vmap[&arg] = &*cpyArg++;
+    }
+
+    SmallVector<ReturnInst*, 8> returns;
+    CloneFunctionInto(cpy, f, vmap, /*ModuleLevelChanges =*/true, returns);
+
+    TypeFinder types;
+    types.run(*mod, true);
+    for(auto *st : types){
+        if(st->hasName())
+            tyDeps += "ty\t" + st->getName().str() + "\t" + structBodyToStr(st) + "\n";
+    }
+
+    string entry = c->cacheDir + "/" + key;
+    sys::fs::create_directories(c->cacheDir);
+
+    std::error_code err;
+    raw_fd_ostream bc{entry + ".bc", err, sys::fs::F_None};
+    if(err) return;
+
+    WriteBitcodeToFile(mod.get(), bc);
+    bc.close();
+
+    //the deps file is written last so its presence implies a complete entry
+    ofstream deps{entry + ".deps"};
+    deps << fnDeps << varDeps << tyDeps;
+}
+
+} //end of namespace ante
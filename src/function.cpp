@@ -1,4 +1,7 @@
 #include "function.h"
+#include "fncache.h"
+#include "timer.h"
+#include <llvm/Transforms/Utils/FunctionComparator.h>
 
 using namespace std;
 using namespace llvm;
@@ -367,6 +370,10 @@ TypedValue compFnHelper(Compiler *c, FuncDecl *fd){
     BasicBlock *caller = c->builder.GetInsertBlock();
     auto *fdn = fd->fdn.get();
 
+    //time is attributed to the module the function was declared in rather than the one compiling it
+    auto &modName = fdn->loc.begin.filename ? *fdn->loc.begin.filename : c->fileName;
+    ScopedTimer timer{"codegen", modName};
+
     if(ModNode *ppn = fdn->modifiers.get()){
         auto ret = compFnWithModifiers(c, fd, ppn);
         c->builder.SetInsertPoint(caller);
@@ -420,6 +427,21 @@ TypedValue compFnHelper(Compiler *c, FuncDecl *fd){
     //stoVar(fdn->name, new Variable(fdn->name, ret, scope));
     c->updateFn(ret, fd, fdn->name, fd->mangledName);
 
+    //When compiling incrementally, reuse the body from a previous build if it is unchanged
+    string cacheKey = "";
+    if(fdn->child && !c->cacheDir.empty() && !c->deferFnPasses){
+        cacheKey = getFnCacheKey(c, fd, fnTy);
+
+        Function *cached;
+        if(!cacheKey.empty() && (cached = loadCachedFn(c, fd, cacheKey))){
+            ret = TypedValue(cached, fnTy);
+            c->updateFn(ret, fd, fdn->name, fd->mangledName);
+            c->builder.SetInsertPoint(caller);
+            return ret;
+        }
+    }
+    auto ctEvaluations = c->ctCtxt->ctEvaluations;
+
     //The above handles everything for a function declaration
     //If the function is a definition, then the body will be compiled here.
     if(fdn->child){
@@ -484,9 +506,16 @@ TypedValue compFnHelper(Compiler *c, FuncDecl *fd){
             return {};
         }
 
-        //optimize!
-        if(!c->errFlag)
+        //optimize!  When compiling with PGO this is delayed until the profile is applied
+        if(!c->errFlag && !c->deferFnPasses){
+            ScopedTimer passTimer{"function passes", modName};
+            TraceEvent trace{"passes", fd->mangledName};
             c->passManager->run(*f);
+        }
+
+        //functions that evaluated compile-time code may have side effects that must be repeated
+        if(!c->errFlag && !cacheKey.empty() && c->ctCtxt->ctEvaluations == ctEvaluations)
+            storeCachedFn(c, fd, f, cacheKey);
     }
 
     c->builder.SetInsertPoint(caller);
@@ -502,6 +531,50 @@ FuncDecl* shallow_copy(FuncDecl* fd, string &mangledName){
 }
 
 
+FuncDecl* getFuncDeclFromVec(vector<shared_ptr<FuncDecl>> &l, string &mangledName);
+
+/*
+ *  Checks if a newly compiled instance of a generic function is identical to an
+ *  instance of the same function compiled with different type arguments, e.g.
+ *  those of List i32 and List u32 or any two pointer types.  If one is found, the
+ *  new instance is erased and the existing one is returned in its place.
+ *
+ *  Instances are grouped by their llvm function type since only instances whose
+ *  bound types have the same layout can be identical.  Their bodies are still
+ *  compared as the same layout does not guarentee the same semantics (eg. a
+ *  signed vs unsigned division).
+ */
+TypedValue reuseIdenticalInstance(Compiler *c, FuncDecl *fd, TypedValue &fn){
+    auto *f = dyn_cast<Function>(fn.val);
+    if(!f || f->isDeclaration()) return fn;
+
+    string key;
+    raw_string_ostream os{key};
+    os << (void*)fd->fdn.get() << ' ';
+    f->getFunctionType()->print(os);
+    os.flush();
+
+    auto &instances = c->layoutInstances[key];
+    for(auto *existing : instances){
+        GlobalNumberState gns;
+        if(FunctionComparator(existing, f, &gns).compare() == 0){
+            f->replaceAllUsesWith(existing);
+            f->eraseFromParent();
+
+            fd->tv.val = existing;
+            auto &list = fd->module->fnDecls[fd->getName()];
+            if(auto *registered = getFuncDeclFromVec(list, fd->mangledName))
+                registered->tv.val = existing;
+
+            return TypedValue(existing, fn.type);
+        }
+    }
+
+    instances.push_back(f);
+    return fn;
+}
+
+
 TypedValue compTemplateFn(Compiler *c, FuncDecl *fd, TypeCheckResult &tc, vector<AnType*> &args){
     //test if bound variant is already compiled
     string mangled = mangle(fd->getName(), args);
@@ -510,6 +583,9 @@ TypedValue compTemplateFn(Compiler *c, FuncDecl *fd, TypeCheckResult &tc, vector
     if(!!(fn = c->getFunction(fd->getName(), mangled)))
         return fn;
 
+    stats.templateInstantiations++;
+    TraceEvent trace{"compTemplateFn", mangled};
+
     //Default return type in case this function has an inferred return type;
     AnType *anRetTy = AnType::getVoid();
 
@@ -532,7 +608,12 @@ TypedValue compTemplateFn(Compiler *c, FuncDecl *fd, TypeCheckResult &tc, vector
 
     //compile the function normally (each typevar should now be
     //substituted with its checked type from the typecheck tc)
-    return c->compFn(fd);
+    fn = c->compFn(fd);
+
+    if(!!fn && !c->errFlag)
+        fn = reuseIdenticalInstance(c, fd, fn);
+
+    return fn;
 }
 
 //Defined in compiler.cpp
@@ -593,6 +674,13 @@ void declareBindings(Compiler *c, vector<pair<string,AnType*>> &bindings){
 //Provide a wrapper for function-compiling methods so that each
 //function is compiled in its own isolated module
 TypedValue Compiler::compFn(FuncDecl *fd){
+    TraceEvent trace{"compFn", fd->mangledName.empty() ? fd->getName() : fd->mangledName};
+    if(traceEnabled){
+        trace.addArg("module", fd->module->name);
+        trace.addArg("caller", compCtxt->callStack.empty() ? "" : compCtxt->callStack.back()->mangledName);
+        trace.addArg("depth", to_string(compCtxt->callStack.size()));
+    }
+
     compCtxt->callStack.push_back(fd);
     auto *continueLabels = compCtxt->continueLabels.release();
     auto *breakLabels = compCtxt->breakLabels.release();
@@ -654,7 +742,11 @@ void Compiler::updateFn(TypedValue &f, FuncDecl *fd, string &name, string &mangl
     }else{
         fd->tv = f;
         list.push_back(shared_ptr<FuncDecl>(fd));
+        vec_fd = fd;
     }
+
+    if(!mangledName.empty())
+        compiledFns[mangledName] = vec_fd;
 }
 
 
@@ -732,12 +824,14 @@ filterBestMatches(Compiler *c, vector<shared_ptr<FuncDecl>> &candidates, vector<
 
 
 FuncDecl* Compiler::getMangledFuncDecl(string name, vector<AnType*> &args){
+    stats.getMangledFuncDeclCalls++;
     auto& fnlist = getFunctionList(name);
     if(fnlist.empty()) return 0;
 
     auto argc = args.size();
 
     auto candidates = filterByArgcAndScope(fnlist, argc, scope);
+    stats.fnCandidates += candidates.size();
     if(candidates.empty()) return 0;
 
     //if there is only one function now, return it.  It will be typechecked later
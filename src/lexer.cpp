@@ -33,6 +33,7 @@ map<int, const char*> tokDict = {
     {Tok_C32, "c32"},
     {Tok_Bool, "bool"},
     {Tok_Void, "Void"},
+    {Tok_SimdType, "SimdType"},
 
     {Tok_Eq, "=="},
     {Tok_NotEq, "!="},
@@ -296,6 +297,29 @@ bool isKeywordAType(int tok){
 		|| tok == Tok_C8 || tok == Tok_C32 || tok == Tok_Bool || tok == Tok_Void;
 }
 
+/*
+*  Returns true if s names a vector type such as f32x8: a primitive
+*  integer or float type followed by an x and a power-of-2 lane count.
+*/
+bool isSimdTypeName(const string &s){
+    size_t x = s.rfind('x');
+    if(x == string::npos || x + 1 == s.length() || s[x+1] == '0')
+        return false;
+
+    auto elem = keywords.find(s.substr(0, x));
+    if(elem == keywords.end() || !isKeywordAType(elem->second) || elem->second == Tok_C8
+            || elem->second == Tok_C32 || elem->second == Tok_Bool || elem->second == Tok_Void)
+        return false;
+
+    unsigned long lanes = 0;
+    for(size_t i = x + 1; i < s.length(); i++){
+        if(!IS_NUMERICAL(s[i]) || lanes > 1024)
+            return false;
+        lanes = lanes * 10 + (s[i] - '0');
+    }
+    return lanes <= 1024 && (lanes & (lanes - 1)) == 0;
+}
+
 /*
 *  Prints a token's type to stdout
 */
@@ -454,6 +478,11 @@ int Lexer::genAlphaNumTok(yy::parser::location_type* loc){
                 cout << key->first << AN_CONSOLE_RESET;
             }
             return key->second;
+        }else if(isSimdTypeName(s)){
+            if(printInput)
+                cout << AN_TYPE_COLOR << s << AN_CONSOLE_RESET;
+            setlextxt(s);
+            return Tok_SimdType;
         }else{//ident
             if(printInput)
                 cout << s;
@@ -75,6 +75,17 @@ void StrLitNode::print(){
     maybePrintArr(next.get());
 }
 
+void InterpolatedStrNode::print(){
+    cout << '"';
+    for(size_t i = 0; i < exprs.size(); i++){
+        cout << strs[i] << "${";
+        exprs[i]->print();
+        putchar('}');
+    }
+    cout << strs.back() << '"';
+    maybePrintArr(next.get());
+}
+
 void CharLitNode::print(){
     cout << '\'' << val << '\'';
     maybePrintArr(next.get());
@@ -3,6 +3,7 @@
 #include "function.h"
 #include "tokens.h"
 #include "jitlinker.h"
+#include "timer.h"
 #include "types.h"
 #include <llvm/ExecutionEngine/Interpreter.h>
 #include <llvm/Linker/Linker.h>
@@ -137,6 +138,9 @@ TypedValue Compiler::compExtract(TypedValue &l, TypedValue &r, BinOpNode *op){
         }else{
             return TypedValue(builder.CreateExtractElement(l.val, r.val), arrty->extTy);
         }
+    }else if(auto *vecty = dyn_cast<AnVectorType>(l.type)){
+        return TypedValue(builder.CreateExtractElement(l.val, r.val), vecty->extTy);
+
     }else if(auto *ptrty = dyn_cast<AnPtrType>(l.type)){
         return TypedValue(builder.CreateLoad(builder.CreateGEP(l.val, r.val)), ptrty->extTy);
 
@@ -205,6 +209,16 @@ TypedValue Compiler::compInsert(BinOpNode *op, Node *assignExpr){
             builder.CreateStore(newVal.val, dest);
             return getVoidLiteral();
         }
+        case TT_Vector: {
+            auto *vecty = (AnVectorType*)tmp.type;
+            if(!typeEq(vecty->extTy, newVal.type))
+                return compErr("Cannot create store of types: "+anTypeToColoredStr(tmp.type)+" <- "
+                        +anTypeToColoredStr(newVal.type), assignExpr->loc);
+
+            auto *ins = builder.CreateInsertElement(tmp.val, newVal.val, index.val);
+            builder.CreateStore(ins, var);
+            return getVoidLiteral();
+        }
         case TT_Ptr: {
             auto *ptrty = (AnPtrType*)tmp.type;
             if(!typeEq(ptrty->extTy, newVal.type))
@@ -242,7 +256,7 @@ TypedValue Compiler::compInsert(BinOpNode *op, Node *assignExpr){
             }
         }
         default:
-            return compErr("Variable being indexed must be an Array or Tuple, but instead is a(n) " +
+            return compErr("Variable being indexed must be an Array, Vector, or Tuple, but instead is a(n) " +
                     anTypeToColoredStr(tmp.type), op->loc); }
 }
 
@@ -402,6 +416,84 @@ bool preferCastOverFunction(Compiler *c, TypedValue &valToCast, ReinterpretCastR
 }
 
 
+/*
+ *  Converts a number or vector of numbers with elements of type from to one with
+ *  elements of type to.  llvmTy is the resulting llvm type, which is a vector
+ *  type when converting vectors.
+ */
+Value* convertNumeric(Compiler *c, Value *val, TypeTag from, TypeTag to, Type *llvmTy){
+    if(isIntTypeTag(to)){
+        if(isIntTypeTag(from))
+            return c->builder.CreateIntCast(val, llvmTy, !isUnsignedTypeTag(from));
+        else if(isUnsignedTypeTag(to))
+            return c->builder.CreateFPToUI(val, llvmTy);
+        else
+            return c->builder.CreateFPToSI(val, llvmTy);
+    }else{
+        if(isFPTypeTag(from))
+            return c->builder.CreateFPCast(val, llvmTy);
+        else if(isUnsignedTypeTag(from))
+            return c->builder.CreateUIToFP(val, llvmTy);
+        else
+            return c->builder.CreateSIToFP(val, llvmTy);
+    }
+}
+
+/*
+ *  Converts a number to the element type of vecTy and copies it into each lane
+ */
+TypedValue splatVector(Compiler *c, AnVectorType *vecTy, TypedValue &scalar){
+    Value *elem = convertNumeric(c, scalar.val, scalar.type->typeTag, vecTy->extTy->typeTag,
+            c->anTypeToLlvmType(vecTy->extTy));
+
+    return TypedValue(c->builder.CreateVectorSplat(vecTy->len, elem), vecTy);
+}
+
+/*
+ *  Casts a number, a tuple of numbers, or a vector with the same number of
+ *  lanes to the vector type vecTy.  Returns an empty TypedValue if no such
+ *  cast exists.
+ */
+TypedValue createVectorCast(Compiler *c, AnVectorType *vecTy, TypedValue &valToCast){
+    AnType *elemTy = vecTy->extTy;
+    if(!isNumericTypeTag(elemTy->typeTag))
+        return {};
+
+    // number -> vector
+    if(isNumericTypeTag(valToCast.type->typeTag))
+        return splatVector(c, vecTy, valToCast);
+
+    // vector -> vector
+    if(auto *fromTy = dyn_cast<AnVectorType>(valToCast.type)){
+        if(fromTy->len != vecTy->len or !isNumericTypeTag(fromTy->extTy->typeTag))
+            return {};
+
+        return TypedValue(convertNumeric(c, valToCast.val, fromTy->extTy->typeTag, elemTy->typeTag,
+                    c->anTypeToLlvmType(vecTy)), vecTy);
+    }
+
+    // tuple -> vector
+    if(valToCast.type->typeTag == TT_Tuple){
+        auto &exts = ((AnAggregateType*)valToCast.type)->extTys;
+        if(exts.size() != vecTy->len)
+            return {};
+
+        Value *vec = UndefValue::get(c->anTypeToLlvmType(vecTy));
+        Type *llvmElemTy = c->anTypeToLlvmType(elemTy);
+
+        for(unsigned i = 0; i < exts.size(); i++){
+            if(!isNumericTypeTag(exts[i]->typeTag))
+                return {};
+
+            Value *elem = c->builder.CreateExtractValue(valToCast.val, i);
+            elem = convertNumeric(c, elem, exts[i]->typeTag, elemTy->typeTag, llvmElemTy);
+            vec = c->builder.CreateInsertElement(vec, elem, c->builder.getInt32(i));
+        }
+        return TypedValue(vec, vecTy);
+    }
+    return {};
+}
+
 /*
  *  Creates a cast instruction appropriate for valToCast's type to castTy.
  */
@@ -438,7 +530,11 @@ TypedValue createCast(Compiler *c, AnType *castTy, TypedValue &valToCast, LOC_TY
     }
 
     //otherwise, fallback on known conversions
-    if(isIntTypeTag(castTy->typeTag)){
+    if(auto *vecTy = dyn_cast<AnVectorType>(castTy)){
+        auto res = createVectorCast(c, vecTy, valToCast);
+        if(!!res) return res;
+
+    }else if(isIntTypeTag(castTy->typeTag)){
         Type *llvmCastTy = c->anTypeToLlvmType(castTy);
 
         // int -> int  (maybe unsigned)
@@ -1028,6 +1124,7 @@ string getName(Node *n){
 void* lookupCFn(string name){
     static map<string,void*> fnMap = {
         {"printf",  (void*)printf},
+        {"snprintf",(void*)snprintf},
         {"puts",    (void*)puts},
         {"putchar", (void*)putchar},
         {"getchar", (void*)getchar},
@@ -1036,6 +1133,9 @@ void* lookupCFn(string name){
         {"realloc", (void*)realloc},
         {"free",    (void*)free},
         {"memcpy",  (void*)memcpy},
+        {"memcmp",  (void*)memcmp},
+        {"memchr",  (void*)static_cast<void*(*)(void*,int,size_t)>(memchr)},
+        {"memset",  (void*)memset},
         {"system",  (void*)system},
         {"strlen",  (void*)strlen},
         {"fopen",   (void*)fopen},
@@ -1049,6 +1149,7 @@ void* lookupCFn(string name){
         {"ftell",   (void*)ftell},
         {"fsetpos", (void*)fsetpos},
         {"fseek",   (void*)fseek},
+        {"setvbuf", (void*)setvbuf},
         {"feof",    (void*)feof},
         {"ferror",  (void*)ferror}
     };
@@ -1067,6 +1168,10 @@ extern map<string, unique_ptr<CtFunc>> compapi;
  *  - Assumes arguments are already type-checked
  */
 TypedValue compMetaFunctionResult(Compiler *c, LOC_TY &loc, string &baseName, string &mangledName, vector<TypedValue> &typedArgs){
+    c->ctCtxt->ctEvaluations++;
+    stats.metaFunctionCalls++;
+    TraceEvent trace{"meta", baseName};
+
     CtFunc* fn;
     if((fn = compapi[baseName].get())){
         void *res;
@@ -1099,6 +1204,28 @@ TypedValue compMetaFunctionResult(Compiler *c, LOC_TY &loc, string &baseName, st
                 return c->compErr("Called function was given " + to_string(typedArgs.size()) +
                         " arguments but was declared to take 1", loc);
 
+            res = (*fn)(c, typedArgs[0]);
+            return *(TypedValue*)res;
+        }else if(baseName == "Ante_shuffle"){
+            if(typedArgs.size() != 3)
+                return c->compErr("Called function was given " + to_string(typedArgs.size()) +
+                        " argument(s) but was declared to take 3", loc);
+
+            if(typedArgs[0].type->typeTag != TT_Vector)
+                return c->compErr("Ante.shuffle expects a vector type, but got " + anTypeToColoredStr(typedArgs[0].type), loc);
+
+            res = (*fn)(c, typedArgs[0], typedArgs[1], typedArgs[2]);
+            return *(TypedValue*)res;
+        }else if(baseName == "Ante_reduce_add" or baseName == "Ante_reduce_mul" or
+                 baseName == "Ante_reduce_min" or baseName == "Ante_reduce_max"){
+            if(typedArgs.size() != 1)
+                return c->compErr("Called function was given " + to_string(typedArgs.size()) +
+                        " arguments but was declared to take 1", loc);
+
+            auto *vecTy = dyn_cast<AnVectorType>(typedArgs[0].type);
+            if(!vecTy or !isNumericTypeTag(vecTy->extTy->typeTag))
+                return c->compErr("Vector reductions expect a vector of numbers, but got " + anTypeToColoredStr(typedArgs[0].type), loc);
+
             res = (*fn)(c, typedArgs[0]);
             return *(TypedValue*)res;
         }else if(baseName == "Ante_forget"){
@@ -1122,6 +1249,7 @@ TypedValue compMetaFunctionResult(Compiler *c, LOC_TY &loc, string &baseName, st
 
         return genericValueToTypedValue(c, gv, fn->retty);
     }else{
+        ScopedTimer timer{"meta-function JIT", c->fileName};
         LLVMInitializeNativeTarget();
         LLVMInitializeNativeAsmPrinter();
 
@@ -1134,6 +1262,8 @@ TypedValue compMetaFunctionResult(Compiler *c, LOC_TY &loc, string &baseName, st
             throw new CtError();
         }
 
+        defineSerialParallelFor(mod);
+
         auto* eBuilder = new EngineBuilder(unique_ptr<llvm::Module>(mod));
         string err;
 
@@ -1567,6 +1697,32 @@ TypedValue handlePrimitiveNumericOp(BinOpNode *bop, Compiler *c, TypedValue &lhs
     }
 }
 
+/*
+ *  Compiles an operator on vectors element-wise, first copying a numeric
+ *  operand into each lane if the other operand is a vector.
+ */
+TypedValue handleVectorOp(BinOpNode *bop, Compiler *c, TypedValue &lhs, TypedValue &rhs){
+    auto *vecTy = dyn_cast<AnVectorType>(lhs.type);
+    if(!vecTy) vecTy = (AnVectorType*)rhs.type;
+
+    if(isNumericTypeTag(lhs.type->typeTag)) lhs = splatVector(c, vecTy, lhs);
+    if(isNumericTypeTag(rhs.type->typeTag)) rhs = splatVector(c, vecTy, rhs);
+
+    if(!c->typeEq(lhs.type, rhs.type))
+        return c->compErr("Operator " + Lexer::getTokStr(bop->op) + " is not overloaded for types "
+               + anTypeToColoredStr(lhs.type) + " and " + anTypeToColoredStr(rhs.type), bop->loc);
+
+    //the llvm instructions for each operator work on vectors as well, so
+    //reuse the scalar operators with the type of each element
+    TypedValue l{lhs.val, vecTy->extTy};
+    TypedValue r{rhs.val, vecTy->extTy};
+    auto res = handlePrimitiveNumericOp(bop, c, l, r);
+
+    if(res.type->typeTag == TT_Bool)
+        return TypedValue(res.val, AnVectorType::get(res.type, vecTy->len));
+    return TypedValue(res.val, vecTy);
+}
+
 /*
  *  Checks the type of a value (usually a function argument) against a type
  *  and attempts to look for and use an implicit conversion if one is found.
@@ -1646,6 +1802,9 @@ TypedValue BinOpNode::compile(Compiler *c){
 
     if(op == '#') return c->compExtract(lhs, rhs, this);
 
+    if(lhs.type->typeTag == TT_Vector or rhs.type->typeTag == TT_Vector)
+        return handleVectorOp(this, c, lhs, rhs);
+
 
     //Check if both Values are numeric, and if so, check if their types match.
     //If not, do an implicit conversion (usually a widening) to match them.
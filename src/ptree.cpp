@@ -6,10 +6,14 @@
 #include "compiler.h"
 #include "yyparser.h"
 #include <stack>
+#include <typeinfo>
 
 using namespace std;
 using namespace ante::parser;
 
+//defined in lexer.cpp
+extern char* lextxt;
+
 namespace ante {
 
     namespace parser {
@@ -26,6 +30,13 @@ namespace ante {
             return root;
         }
 
+        //Records the kind and size of each node created for -mem-report
+        template<typename T>
+        T* trackNode(T *node){
+            recordAstNode(typeid(*node), sizeof(T));
+            return node;
+        }
+
         Node* setElse(Node *ifn, Node *elseN){
             if(auto *n = dynamic_cast<IfNode*>(ifn)){
                 if(n->elseN)
@@ -65,7 +76,7 @@ namespace ante {
 
         //initializes the root node
         void createRoot(LOC_TY& loc){
-            root = new RootNode(loc);
+            root = trackNode(new RootNode(loc));
         }
 
         void createRoot(){
@@ -115,9 +126,9 @@ namespace ante {
         TypeNode* TypeNode::addModifiers(ModNode *m){
             TypeNode *ext = extTy.get();
 
-            //arrays have their size as their second extty so they
+            //arrays and vectors have their size as their second extty so they
             //must be handled specially
-            if(type == TT_Array){
+            if(type == TT_Array or type == TT_Vector){
                 ext->addModifiers(m);
                 ext = (TypeNode*)ext->next.get();
             }else{
@@ -138,7 +149,7 @@ namespace ante {
         TypeNode* TypeNode::addModifier(int m){
             TypeNode *ext = extTy.get();
 
-            if(type == TT_Array){
+            if(type == TT_Array or type == TT_Vector){
                 ext->addModifier(m);
                 ext = (TypeNode*)ext->next.get();
             }else{
@@ -204,7 +215,7 @@ namespace ante {
                 s = s->next.release();
             }
 
-            return new GlobalNode(loc, move(vars));
+            return trackNode(new GlobalNode(loc, move(vars)));
         }
 
         void TypeNode::copyModifiersFrom(const TypeNode *tn){
@@ -288,7 +299,7 @@ namespace ante {
                 }
             }
 
-            return new IntLitNode(loc, str, type);
+            return trackNode(new IntLitNode(loc, str, type));
         }
 
         Node* mkFltLitNode(LOC_TY loc, char* s){
@@ -310,19 +321,107 @@ namespace ante {
                 }
             }
 
-            return new FltLitNode(loc, str, type);
+            return trackNode(new FltLitNode(loc, str, type));
+        }
+
+        /*
+         * Parses the expr of a ${expr} site within a Str literal with its own lexer.
+         * The current lexer and root are restored afterward so the outer parse can
+         * continue.  Returns nullptr if there is a syntax error.
+         */
+        Node* parseInterpolatedExpr(LOC_TY &loc, string &src, size_t pos){
+            Lexer *outerLexer = yylexer;
+            RootNode *outerRoot = root;
+            char *outerTxt = lextxt;
+
+            yylexer = new Lexer(loc.begin.filename, src, loc.begin.line-1, loc.begin.column + pos);
+            root = nullptr;
+
+            yy::parser p{};
+            int flag = p.parse();
+            RootNode *expr = root;
+
+            delete yylexer;
+            yylexer = outerLexer;
+            root = outerRoot;
+            lextxt = outerTxt;
+
+            if(flag != PE_OK or !expr)
+                return nullptr;
+
+            if(!expr->funcs.empty() or !expr->types.empty() or !expr->traits.empty()
+                    or !expr->extensions.empty() or !expr->imports.empty()){
+                ante::error("Only expressions may be interpolated into a Str", loc);
+                return nullptr;
+            }
+
+            Node *ret;
+            if(expr->main.empty()){
+                ante::error("Empty interpolation in Str literal", loc);
+                return nullptr;
+            }else if(expr->main.size() == 1){
+                ret = expr->main[0].release();
+            }else{
+                auto *seq = trackNode(new SeqNode(expr->loc));
+                seq->sequence = move(expr->main);
+                ret = seq;
+            }
+
+            delete expr;
+            return ret;
         }
 
+        /*
+         * Creates a StrLitNode, or an InterpolatedStrNode if s contains
+         * any ${expr} sites not preceded by a \
+         */
         Node* mkStrLitNode(LOC_TY loc, char* s){
-            return new StrLitNode(loc, s);
+            string val = s;
+            unique_ptr<InterpolatedStrNode> isn;
+
+            size_t start = 0;
+            size_t idx = val.find("${");
+            while(idx != string::npos){
+                if(idx > 0 and val[idx-1] == '\\'){
+                    idx = val.find("${", idx + 2);
+                    continue;
+                }
+
+                auto posEnd = val.find("}", idx);
+                if(posEnd == string::npos){
+                    ante::error("Interpolated string must have a closing bracket", loc);
+                    return nullptr;
+                }
+
+                //this is the ${...} part of the string without the ${ and }
+                string m = val.substr(idx + 2, posEnd - (idx + 2));
+                Node *expr = parseInterpolatedExpr(loc, m, idx);
+                if(!expr)
+                    return nullptr;
+
+                if(!isn)
+                    isn.reset(trackNode(new InterpolatedStrNode(loc)));
+
+                isn->strs.push_back(val.substr(start, idx - start));
+                isn->exprs.emplace_back(expr);
+
+                start = posEnd + 1;
+                idx = val.find("${", start);
+            }
+
+            if(!isn)
+                return trackNode(new StrLitNode(loc, val));
+
+            isn->strs.push_back(val.substr(start));
+            return isn.release();
         }
 
         Node* mkCharLitNode(LOC_TY loc, char* s){
-            return new CharLitNode(loc, s[0]);
+            return trackNode(new CharLitNode(loc, s[0]));
         }
 
         Node* mkBoolLitNode(LOC_TY loc, char b){
-            return new BoolLitNode(loc, b);
+            return trackNode(new BoolLitNode(loc, b));
         }
 
         Node* mkArrayNode(LOC_TY loc, Node *expr){
@@ -333,7 +432,7 @@ namespace ante {
                 expr->next.release();
                 expr = nxt;
             }
-            return new ArrayNode(loc, exprs);
+            return trackNode(new ArrayNode(loc, exprs));
         }
 
         Node* mkTupleNode(LOC_TY loc, Node *expr){
@@ -344,15 +443,15 @@ namespace ante {
                 expr->next.release();
                 expr = nxt;
             }
-            return new TupleNode(loc, exprs);
+            return trackNode(new TupleNode(loc, exprs));
         }
 
         Node* mkModNode(LOC_TY loc, ante::TokenType mod){
-            return new ModNode(loc, mod);
+            return trackNode(new ModNode(loc, mod));
         }
         
         Node* mkCompilerDirective(LOC_TY loc, Node *n){
-            return new ModNode(loc, n);
+            return trackNode(new ModNode(loc, n));
         }
 
         Node* mkTypeNode(LOC_TY loc, TypeTag type, char* typeName, Node* extTy = nullptr){
@@ -365,19 +464,42 @@ namespace ante {
                     exit(1);
                 }
             }
-            return new TypeNode(loc, type, typeName, static_cast<TypeNode*>(extTy));
+            return trackNode(new TypeNode(loc, type, typeName, static_cast<TypeNode*>(extTy)));
+        }
+
+        /*
+         *  Creates the TypeNode of a vector type such as f32x8 from its name.
+         *  The element type is stored as the extTy and the number of lanes as
+         *  an IntLitNode after it, in the same layout as array types.
+         */
+        Node* mkSimdTypeNode(LOC_TY loc, char* s){
+            static const map<string, TypeTag> elemTypes = {
+                {"i8", TT_I8}, {"i16", TT_I16}, {"i32", TT_I32}, {"i64", TT_I64},
+                {"u8", TT_U8}, {"u16", TT_U16}, {"u32", TT_U32}, {"u64", TT_U64},
+                {"isz", TT_Isz}, {"usz", TT_Usz},
+                {"f16", TT_F16}, {"f32", TT_F32}, {"f64", TT_F64},
+            };
+
+            string name = s;
+            size_t x = name.rfind('x');
+            TypeTag elemTag = elemTypes.at(name.substr(0, x));
+            string lanes = name.substr(x + 1);
+
+            Node *elem = mkTypeNode(loc, elemTag, (char*)"");
+            elem->next.reset(mkIntLitNode(loc, (char*)lanes.c_str()));
+            return mkTypeNode(loc, TT_Vector, (char*)"", elem);
         }
 
         Node* mkTypeCastNode(LOC_TY loc, Node *l, Node *r){
-            return new TypeCastNode(loc, static_cast<TypeNode*>(l), r);
+            return trackNode(new TypeCastNode(loc, static_cast<TypeNode*>(l), r));
         }
 
         Node* mkUnOpNode(LOC_TY loc, int op, Node* r){
-            return new UnOpNode(loc, op, r);
+            return trackNode(new UnOpNode(loc, op, r));
         }
 
         Node* mkBinOpNode(LOC_TY loc, int op, Node* l, Node* r){
-            return new BinOpNode(loc, op, l, r);
+            return trackNode(new BinOpNode(loc, op, l, r));
         }
 
         Node* mkSeqNode(LOC_TY loc, Node *l, Node *r){
@@ -385,7 +507,7 @@ namespace ante {
                 seq->sequence.emplace_back(r);
                 return seq;
             }else{
-                SeqNode *s = new SeqNode(loc);
+                SeqNode *s = trackNode(new SeqNode(loc));
                 s->sequence.emplace_back(l);
                 s->sequence.emplace_back(r);
                 return s;
@@ -393,17 +515,17 @@ namespace ante {
         }
 
         Node* mkBlockNode(LOC_TY loc, Node *b){
-            return new BlockNode(loc, b);
+            return trackNode(new BlockNode(loc, b));
         }
 
         Node* mkRetNode(LOC_TY loc, Node* expr){
-            return new RetNode(loc, expr);
+            return trackNode(new RetNode(loc, expr));
         }
 
 
         //returns true if type->extTy should be defined
         bool typeHasExtData(TypeTag t){
-            return t == TT_Tuple or t == TT_Array or t == TT_Ptr or t == TT_Data or t == TT_Function
+            return t == TT_Tuple or t == TT_Array or t == TT_Vector or t == TT_Ptr or t == TT_Data or t == TT_Function
                 or t == TT_TaggedUnion or t == TT_MetaFunction;
 
         }
@@ -415,16 +537,16 @@ namespace ante {
             if(!n or n == (void*)1) return 0;
 
             auto loc = copyLoc(n->loc);
-            TypeNode *cpy = new TypeNode(loc, n->type, n->typeName, nullptr);
+            TypeNode *cpy = trackNode(new TypeNode(loc, n->type, n->typeName, nullptr));
 
-            //arrays can have an IntLit in their extTy so handle them specially
-            if(n->type == TT_Array){
+            //arrays and vectors can have an IntLit in their extTy so handle them specially
+            if(n->type == TT_Array or n->type == TT_Vector){
                 cpy->extTy.reset(copy(n->extTy));
 
                 auto *len = (IntLitNode*)n->extTy->next.get();
                 if(len){
                     auto loc_cpy = copyLoc(len->loc);
-                    auto *len_cpy = new IntLitNode(loc_cpy, len->val, len->type);
+                    auto *len_cpy = trackNode(new IntLitNode(loc_cpy, len->val, len->type));
                     cpy->extTy->next.reset(len_cpy);
                 }
             }else if(n->extTy.get()){
@@ -472,7 +594,7 @@ namespace ante {
             //Note: there will always be at least one varNode
             const TypeNode* ty = (TypeNode*)tExpr;
             VarNode* vn = (VarNode*)varNodes;
-            Node *first = new NamedValNode(loc, vn->name, tExpr);
+            Node *first = trackNode(new NamedValNode(loc, vn->name, tExpr));
             Node *nxt = first;
 
             if(!prev) setRoot(first);
@@ -482,7 +604,7 @@ namespace ante {
                 TypeNode *tyNode = copy(ty);
                 LOC_TY loccpy = copyLoc(vn->loc);
 
-                nxt->next.reset(new NamedValNode(loccpy, vn->name, tyNode));
+                nxt->next.reset(trackNode(new NamedValNode(loccpy, vn->name, tyNode)));
                 nxt->next->prev = nxt;
                 nxt = nxt->next.get();
             }
@@ -491,48 +613,48 @@ namespace ante {
         }
 
         Node* mkVarNode(LOC_TY loc, char* s){
-            return new VarNode(loc, s);
+            return trackNode(new VarNode(loc, s));
         }
 
         Node* mkImportNode(LOC_TY loc, Node* expr){
-            return new ImportNode(loc, expr);
+            return trackNode(new ImportNode(loc, expr));
         }
 
         Node* mkLetBindingNode(LOC_TY loc, char* s, Node* mods, Node* tExpr, Node* expr){
-            return new LetBindingNode(loc, s, mods, tExpr, expr);
+            return trackNode(new LetBindingNode(loc, s, mods, tExpr, expr));
         }
 
         Node* mkVarDeclNode(LOC_TY loc, char* s, Node* mods, Node* tExpr, Node* expr){
-            return new VarDeclNode(loc, s, mods, tExpr, expr);
+            return trackNode(new VarDeclNode(loc, s, mods, tExpr, expr));
         }
 
         Node* mkVarAssignNode(LOC_TY loc, Node* var, Node* expr, bool freeLval = true){
-            return new VarAssignNode(loc, var, expr, freeLval);
+            return trackNode(new VarAssignNode(loc, var, expr, freeLval));
         }
 
         Node* mkExtNode(LOC_TY loc, Node* ty, Node* methods, Node* traits){
-            return new ExtNode(loc, (TypeNode*)ty, methods, (TypeNode*)traits);
+            return trackNode(new ExtNode(loc, (TypeNode*)ty, methods, (TypeNode*)traits));
         }
 
         Node* mkIfNode(LOC_TY loc, Node* con, Node* then, Node* els){
-            return new IfNode(loc, con, then, els);
+            return trackNode(new IfNode(loc, con, then, els));
         }
 
         Node* mkJumpNode(LOC_TY loc, int jumpType, Node* expr){
-            return new JumpNode(loc, jumpType, expr);
+            return trackNode(new JumpNode(loc, jumpType, expr));
         }
 
         Node* mkWhileNode(LOC_TY loc, Node* con, Node* body){
-            return new WhileNode(loc, con, body);
+            return trackNode(new WhileNode(loc, con, body));
         }
 
         Node* mkForNode(LOC_TY loc, Node* var, Node* range, Node* body){
-            return new ForNode(loc, (char*)var, range, body);
+            return trackNode(new ForNode(loc, (char*)var, range, body));
         }
 
         Node* mkFuncDeclNode(LOC_TY loc, Node* s, Node* mods, Node* tExpr, Node* p, Node* b){
-            auto ret = new FuncDeclNode(loc, (char*)s,
-                    (ModNode*)mods, (TypeNode*)tExpr, (NamedValNode*)p, b);
+            auto ret = trackNode(new FuncDeclNode(loc, (char*)s,
+                    (ModNode*)mods, (TypeNode*)tExpr, (NamedValNode*)p, b));
 
             //s is copied from lextxt, and may or may not be equal
             if(s) free(s);
@@ -545,7 +667,7 @@ namespace ante {
                 params.emplace_back((TypeNode*)p);
                 p = p->next.release();
             }
-            return new DataDeclNode(loc, s, b, getTupleSize(b), params);
+            return trackNode(new DataDeclNode(loc, s, b, getTupleSize(b), params));
         }
 
 
@@ -553,15 +675,15 @@ namespace ante {
             vector<unique_ptr<MatchBranchNode>> branches;
             branch->next.release();
             branches.emplace_back((MatchBranchNode*)branch);
-            return new MatchNode(loc, expr, branches);
+            return trackNode(new MatchNode(loc, expr, branches));
         }
 
         Node* mkMatchBranchNode(LOC_TY loc, Node* pattern, Node* branch){
-            return new MatchBranchNode(loc, pattern, branch);
+            return trackNode(new MatchBranchNode(loc, pattern, branch));
         }
 
         Node* mkTraitNode(LOC_TY loc, char* s, Node* fns){
-            return new TraitNode(loc, s, fns);
+            return trackNode(new TraitNode(loc, s, fns));
         }
     } //end of namespace ante::parser
 } //end of namespace ante
@@ -0,0 +1,222 @@
+/*
+ *      runtime.c
+ * Work-stealing thread pool behind the prelude's parallel_for.  This is
+ * compiled to runtime.o and linked into every program that calls it.
+ *
+ * The iterations of a loop are first divided evenly between the workers.
+ * Each worker runs small chunks from the front of its own range and once
+ * that is empty steals the back half of the range of another worker.
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define MAX_WORKERS 256
+
+/* Chunks are small enough that each worker takes about this many */
+#define CHUNKS_PER_WORKER 16
+
+/*
+ * The iterations [begin, end) remaining for one worker, packed into a
+ * single word so the owner and thieves can both take from it with one
+ * compare and exchange.
+ */
+typedef struct {
+    _Atomic uint64_t range;
+    char pad[64 - sizeof(uint64_t)]; /* keep each range on its own cache line */
+} WorkerRange;
+
+typedef struct {
+    void (*body)(int32_t);
+    int64_t start, step;
+    uint32_t grain;
+    _Atomic uint64_t remaining;
+} Job;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake, done;
+
+    /* number of workers including the thread calling ante_parallel_for */
+    unsigned numWorkers;
+
+    /* incremented for each new job so sleeping workers know to wake */
+    unsigned generation;
+
+    /* workers other than the caller that have not finished the current job */
+    unsigned busy;
+
+    Job *job;
+    WorkerRange ranges[MAX_WORKERS];
+} pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+/* Set in worker threads and during a parallel loop so nested loops run serially */
+static _Thread_local int inParallelFor = 0;
+
+
+static uint64_t packRange(uint32_t begin, uint32_t end){
+    return (uint64_t)begin << 32 | end;
+}
+
+static uint32_t rangeBegin(uint64_t r){ return (uint32_t)(r >> 32); }
+static uint32_t rangeEnd(uint64_t r){ return (uint32_t)r; }
+
+
+/*
+ * Takes up to grain iterations from the front of worker id's range.
+ * Returns 0 if its range is empty.
+ */
+static int takeChunk(unsigned id, uint32_t grain, uint32_t *begin, uint32_t *end){
+    _Atomic uint64_t *range = &pool.ranges[id].range;
+    uint64_t r = atomic_load(range);
+
+    for(;;){
+        uint32_t b = rangeBegin(r), e = rangeEnd(r);
+        if(b >= e) return 0;
+
+        uint32_t mid = e - b > grain ? b + grain : e;
+        if(atomic_compare_exchange_weak(range, &r, packRange(mid, e))){
+            *begin = b;
+            *end = mid;
+            return 1;
+        }
+    }
+}
+
+/*
+ * Moves the back half of another worker's range into worker id's own
+ * range, which must be empty.  Returns 0 if every range was empty.
+ *
+ * Iterations are never handed out twice so a range can't change back
+ * to a value a thief has already read, and a failed exchange always
+ * means another worker took from it first.
+ */
+static int steal(unsigned id){
+    for(unsigned i = 1; i < pool.numWorkers; i++){
+        _Atomic uint64_t *victim = &pool.ranges[(id + i) % pool.numWorkers].range;
+        uint64_t r = atomic_load(victim);
+
+        for(;;){
+            uint32_t b = rangeBegin(r), e = rangeEnd(r);
+            if(b >= e) break;
+
+            uint32_t mid = b + (e - b) / 2;
+            if(atomic_compare_exchange_weak(victim, &r, packRange(b, mid))){
+                atomic_store(&pool.ranges[id].range, packRange(mid, e));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void runJob(unsigned id, Job *job){
+    uint32_t b, e;
+    do{
+        while(takeChunk(id, job->grain, &b, &e)){
+            for(uint32_t k = b; k < e; k++)
+                job->body((int32_t)(job->start + (int64_t)k * job->step));
+
+            atomic_fetch_sub(&job->remaining, e - b);
+        }
+    }while(atomic_load(&job->remaining) > 0 && steal(id));
+}
+
+static void* workerMain(void *arg){
+    unsigned id = (unsigned)(uintptr_t)arg;
+    unsigned seen = 0;
+    inParallelFor = 1;
+
+    pthread_mutex_lock(&pool.lock);
+    for(;;){
+        while(pool.generation == seen)
+            pthread_cond_wait(&pool.wake, &pool.lock);
+
+        seen = pool.generation;
+        Job *job = pool.job;
+        pthread_mutex_unlock(&pool.lock);
+
+        runJob(id, job);
+
+        pthread_mutex_lock(&pool.lock);
+        if(--pool.busy == 0)
+            pthread_cond_signal(&pool.done);
+    }
+    return NULL;
+}
+
+/*
+ * Starts one worker per core, or ANTE_NUM_THREADS workers if it is set,
+ * the first time it is called.  Returns the number of workers.
+ */
+static unsigned startPool(void){
+    if(pool.numWorkers)
+        return pool.numWorkers;
+
+    const char *env = getenv("ANTE_NUM_THREADS");
+    long n = env ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+    if(n < 1) n = 1;
+    if(n > MAX_WORKERS) n = MAX_WORKERS;
+
+    pool.numWorkers = 1;
+    for(long i = 1; i < n; i++){
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, workerMain, (void*)(uintptr_t)i))
+            break;
+
+        pthread_detach(thread);
+        pool.numWorkers++;
+    }
+    return pool.numWorkers;
+}
+
+/*
+ * Calls body with each integer from start to end inclusive, counting by
+ * step, on every worker of the pool.  A step of 0 runs start once if it
+ * equals end and otherwise runs nothing.  These are the iterations of a
+ * for loop over the same Range, except that a for loop with a step of 0
+ * and start > end never terminates.
+ */
+void ante_parallel_for(int32_t start, int32_t end, int32_t step, void (*body)(int32_t)){
+    uint64_t n;
+    if(step > 0)
+        n = start <= end ? ((int64_t)end - start) / step + 1 : 0;
+    else if(step < 0)
+        n = start >= end ? ((int64_t)start - end) / -(int64_t)step + 1 : 0;
+    else
+        n = start == end;
+
+    if(n == 0) return;
+
+    if(inParallelFor || n == 1 || n > UINT32_MAX || startPool() == 1){
+        for(uint64_t k = 0; k < n; k++)
+            body((int32_t)(start + (int64_t)k * step));
+        return;
+    }
+
+    unsigned workers = pool.numWorkers;
+    uint64_t grain = n / (workers * CHUNKS_PER_WORKER);
+
+    Job job = {body, start, step, grain ? (uint32_t)grain : 1, n};
+
+    for(unsigned i = 0; i < workers; i++)
+        atomic_store(&pool.ranges[i].range, packRange(n * i / workers, n * (i + 1) / workers));
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = &job;
+    pool.busy = workers - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    inParallelFor = 1;
+    runJob(0, &job);
+    inParallelFor = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    while(pool.busy > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+}
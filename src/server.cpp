@@ -0,0 +1,274 @@
+/*
+ *      server.cpp
+ * Provides the persistent compile server started with --server <socket>
+ * and the --client which forwards its command line to it.
+ *
+ * A request consists of a 32-bit length sent along with the client's stdout
+ * and stderr file descriptors, followed by the working directory and each
+ * argument as nul-terminated strings.  The server responds with the 32-bit
+ * exit status of the compilation once it finishes.  Diagnostics are written
+ * directly to the client's stdout and stderr.
+ */
+#include "server.h"
+#include "compiler.h"
+#include "target.h"
+#include "timer.h"
+#include <iostream>
+#include <cstring>
+
+#ifdef unix
+#  include <climits>
+#  include <csignal>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace ante {
+
+#ifdef unix
+
+bool writeAll(int fd, const char *buf, size_t len){
+    while(len > 0){
+        ssize_t n = write(fd, buf, len);
+        if(n <= 0) return false;
+        buf += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool readAll(int fd, char *buf, size_t len){
+    while(len > 0){
+        ssize_t n = read(fd, buf, len);
+        if(n <= 0) return false;
+        buf += n;
+        len -= n;
+    }
+    return true;
+}
+
+int connectTo(const char *socketPath, bool listening){
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(sock < 0) return -1;
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+
+    if(listening){
+        unlink(socketPath);
+        if(bind(sock, (sockaddr*)&addr, sizeof(addr)) || listen(sock, SOMAXCONN)){
+            close(sock);
+            return -1;
+        }
+    }else if(connect(sock, (sockaddr*)&addr, sizeof(addr))){
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+
+/*
+ *  Receives a request's working directory and arguments into args
+ *  and the client's stdout and stderr into fds
+ */
+bool recvRequest(int conn, vector<string> &args, int fds[2]){
+    uint32_t len;
+    iovec iov = {&len, sizeof(len)};
+
+    char ctrl[CMSG_SPACE(2 * sizeof(int))];
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+
+    if(recvmsg(conn, &msg, 0) != sizeof(len))
+        return false;
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if(!cmsg || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(2 * sizeof(int)))
+        return false;
+    memcpy(fds, CMSG_DATA(cmsg), 2 * sizeof(int));
+
+    string payload(len, '\0');
+    if(!readAll(conn, &payload[0], len))
+        return false;
+
+    size_t start = 0;
+    for(size_t i = 0; i < payload.size(); i++){
+        if(payload[i] == '\0'){
+            args.push_back(payload.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    return !args.empty();
+}
+
+
+/*
+ *  Compiles a single request in a process forked from the warm server
+ *  state and returns the exit status of the compilation
+ */
+int compileRequest(vector<string> &args, int fds[2], shared_ptr<llvm::LLVMContext> &ctxt){
+    pid_t pid = fork();
+    if(pid < 0) return 1;
+
+    if(pid == 0){
+        dup2(fds[0], STDOUT_FILENO);
+        dup2(fds[1], STDERR_FILENO);
+
+        if(chdir(args[0].c_str())){
+            cerr << "Could not change directory to " << args[0] << endl;
+            _exit(1);
+        }
+
+        vector<const char*> argv = {"ante"};
+        for(size_t i = 1; i < args.size(); i++)
+            argv.push_back(args[i].c_str());
+
+        auto *cargs = parseArgs(argv.size(), argv.data());
+        if(cargs->hasArg(Args::NoColor)) colored_output = false;
+
+        compileInputs(cargs, ctxt);
+
+        //_exit skips the report and trace normally written at exit
+        if(timeReportEnabled)
+            printTimeReport();
+
+        if(traceEnabled)
+            writeTrace();
+
+        cout.flush();
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+
+int runServer(const char *socketPath){
+    int sock = connectTo(socketPath, true);
+    if(sock < 0){
+        cerr << "Could not listen on " << socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    //Parse and declare the prelude once.  It is imported from allCompiledModules by each request.
+    auto ctxt = make_shared<llvm::LLVMContext>();
+    Compiler warm{nullptr, true, ctxt};
+    warm.compilePrelude();
+
+    //each connection is handled by a child process which is reaped automatically
+    signal(SIGCHLD, SIG_IGN);
+
+    while(true){
+        int conn = accept(sock, nullptr, nullptr);
+        if(conn < 0) continue;
+
+        if(fork() == 0){
+            close(sock);
+            signal(SIGCHLD, SIG_DFL);
+
+            vector<string> args;
+            int fds[2];
+            int32_t status = 1;
+
+            if(recvRequest(conn, args, fds)){
+                status = compileRequest(args, fds, ctxt);
+                close(fds[0]);
+                close(fds[1]);
+            }
+
+            writeAll(conn, (char*)&status, sizeof(status));
+            close(conn);
+            _exit(0);
+        }
+        close(conn);
+    }
+}
+
+
+int runClient(const char *socketPath, int argc, const char **argv){
+    int sock = connectTo(socketPath, false);
+    if(sock < 0){
+        cerr << "Could not connect to ante server at " << socketPath << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    char cwd[PATH_MAX];
+    if(!getcwd(cwd, sizeof(cwd))){
+        cerr << "Could not get the current working directory\n";
+        return 1;
+    }
+
+    //forward every argument except for --client and its socket
+    string payload = string(cwd) + '\0';
+    for(int i = 1; i < argc; i++){
+        if(!strcmp(argv[i], "--client")){
+            i++;
+            continue;
+        }
+
+        if(!strncmp(argv[i], "--client=", 9))
+            continue;
+
+        payload += string(argv[i]) + '\0';
+    }
+
+    uint32_t len = payload.size();
+    iovec iov = {&len, sizeof(len)};
+
+    int fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+    char ctrl[CMSG_SPACE(sizeof(fds))];
+    memset(ctrl, 0, sizeof(ctrl));
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    int32_t status = 1;
+    if(sendmsg(sock, &msg, 0) != sizeof(len) || !writeAll(sock, payload.c_str(), len)
+            || !readAll(sock, (char*)&status, sizeof(status))){
+        cerr << "Lost connection to ante server at " << socketPath << endl;
+        status = 1;
+    }
+
+    close(sock);
+    return status;
+}
+
+#else
+
+int runServer(const char *socketPath){
+    cerr << "--server is only supported on unix platforms\n";
+    return 1;
+}
+
+int runClient(const char *socketPath, int argc, const char **argv){
+    cerr << "--client is only supported on unix platforms\n";
+    return 1;
+}
+
+#endif
+
+} //end of namespace ante
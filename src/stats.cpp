@@ -0,0 +1,277 @@
+/*
+ *      stats.cpp
+ * Provides the counters printed by -stats and written by -stats-json
+ * so changes in the amount of work done by the compiler can be tracked,
+ * and the memory usage report printed by -mem-report.
+ */
+#include "stats.h"
+#include "compiler.h"
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <typeindex>
+#include <unordered_set>
+
+#ifdef __GNUG__
+#  include <cxxabi.h>
+#endif
+
+#ifdef unix
+#  include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace ante {
+
+extern AnTypeContainer typeArena;
+
+CompilerStats stats;
+
+/*
+ *  Returns the name and value of each counter as a string
+ */
+vector<pair<const char*, string>> getCounters(){
+    return {
+        {"typeEqCalls",             to_string(stats.typeEqCalls)},
+        {"typeEqHelperCalls",       to_string(stats.typeEqHelperCalls)},
+        {"typeEqMaxDepth",          to_string(stats.typeEqMaxDepth)},
+        {"getMangledFuncDeclCalls", to_string(stats.getMangledFuncDeclCalls)},
+        {"fnCandidates",            to_string(stats.fnCandidates)},
+        {"templateInstantiations",  to_string(stats.templateInstantiations)},
+        {"metaFunctionCalls",       to_string(stats.metaFunctionCalls)},
+        {"exitScopeFrees",          to_string(stats.exitScopeFrees)},
+        {"astNodes",                to_string(stats.astNodes)},
+    };
+}
+
+/*
+ *  Returns the llvm instruction count of each function defined in the module
+ */
+vector<pair<string, size_t>> getInstructionCounts(Compiler *c){
+    vector<pair<string, size_t>> counts;
+
+    //the module is given to the JIT with -r
+    if(!c->module) return counts;
+
+    for(auto &f : *c->module){
+        if(f.isDeclaration()) continue;
+
+        size_t insts = 0;
+        for(auto &bb : f)
+            insts += bb.size();
+        counts.emplace_back(f.getName().str(), insts);
+    }
+    return counts;
+}
+
+string jsonStr(const string &s){
+    string ret = "\"";
+    for(char ch : s){
+        if(ch == '"' || ch == '\\'){
+            ret += '\\';
+            ret += ch;
+        }else if((unsigned char)ch < 0x20){
+            char esc[7];
+            snprintf(esc, sizeof(esc), "\\u%04x", ch);
+            ret += esc;
+        }else{
+            ret += ch;
+        }
+    }
+    return ret + "\"";
+}
+
+
+void printStats(Compiler *c){
+    fprintf(stderr, "\n===------------------------- Ante statistics -------------------------===\n");
+    fprintf(stderr, "  %s\n\n", c->fileName.c_str());
+
+    for(auto &counter : getCounters())
+        fprintf(stderr, "  %14s  %s\n", counter.second.c_str(), counter.first);
+
+    fputc('\n', stderr);
+    for(auto &count : typeArena.getTypeCounts())
+        fprintf(stderr, "  %14zu  %s\n", count.second, count.first);
+
+    auto fns = getInstructionCounts(c);
+    size_t total = 0;
+    for(auto &fn : fns)
+        total += fn.second;
+
+    sort(fns.begin(), fns.end(), [](const pair<string, size_t> &l, const pair<string, size_t> &r){
+        return l.second > r.second;
+    });
+
+    fprintf(stderr, "\n  %14zu  llvm instructions in %zu functions\n", total, fns.size());
+    for(size_t i = 0; i < fns.size() && i < 10; i++)
+        fprintf(stderr, "  %14zu  %s\n", fns[i].second, fns[i].first.c_str());
+    fputc('\n', stderr);
+}
+
+
+string statsToJson(Compiler *c){
+    string json = "{\n";
+    for(auto &counter : getCounters())
+        json += "    \"" + string(counter.first) + "\": " + counter.second + ",\n";
+
+    json += "    \"types\": {";
+    bool first = true;
+    for(auto &count : typeArena.getTypeCounts()){
+        json += (first ? "\"" : ", \"") + string(count.first) + "\": " + to_string(count.second);
+        first = false;
+    }
+
+    json += "},\n    \"llvmInstructions\": {";
+    first = true;
+    for(auto &fn : getInstructionCounts(c)){
+        json += (first ? "\n        " : ",\n        ") + jsonStr(fn.first) + ": " + to_string(fn.second);
+        first = false;
+    }
+    return json + "\n    }\n}";
+}
+
+
+struct MemUsage {
+    size_t count, bytes;
+};
+
+//Count and shallow size of each kind of parse tree node created
+map<type_index, MemUsage> astNodeKinds;
+
+void recordAstNode(const type_info &kind, size_t bytes){
+    auto &usage = astNodeKinds[type_index(kind)];
+    usage.count++;
+    usage.bytes += bytes;
+    stats.astNodes++;
+}
+
+
+void resetStats(){
+    stats = CompilerStats();
+    astNodeKinds.clear();
+}
+
+/*
+ *  Returns the unqualified class name of a node kind, eg. IntLitNode
+ */
+string nodeKindName(const type_index &kind){
+    string name = kind.name();
+#ifdef __GNUG__
+    int status;
+    char *demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if(status == 0){
+        name = demangled;
+        free(demangled);
+    }
+#endif
+    auto colon = name.rfind("::");
+    return colon == string::npos ? name : name.substr(colon + 2);
+}
+
+
+template<typename T>
+size_t stringMapBytes(const llvm::StringMap<T> &map){
+    size_t bytes = map.getNumBuckets() * (sizeof(void*) + sizeof(unsigned));
+    for(auto &entry : map)
+        bytes += sizeof(entry) + entry.getKeyLength() + 1;
+    return bytes;
+}
+
+/*
+ *  Adds the number of function declarations and the bytes used by the
+ *  tables of a module to usage.  FuncDecls are shared between the modules
+ *  that import them so each is only counted once.
+ */
+void addModuleUsage(Module *m, MemUsage &usage, unordered_set<FuncDecl*> &seen){
+    usage.count++;
+    usage.bytes += sizeof(Module) + m->name.capacity() + stringMapBytes(m->fnDecls)
+        + stringMapBytes(m->userTypes) + stringMapBytes(m->traits);
+
+    for(auto &entry : m->fnDecls){
+        usage.bytes += entry.second.capacity() * sizeof(shared_ptr<FuncDecl>);
+        for(auto &fd : entry.second){
+            if(seen.insert(fd.get()).second){
+                usage.bytes += sizeof(FuncDecl) + fd->mangledName.capacity()
+                    + fd->returns.capacity() * sizeof(pair<TypedValue, LOC_TY>);
+            }
+        }
+    }
+}
+
+
+void printMemReport(Compiler *c){
+    fprintf(stderr, "\n===------------------------- Ante memory report -------------------------===\n");
+    fprintf(stderr, "  %s\n\n", c->fileName.c_str());
+    fprintf(stderr, "  %10s %12s  %s\n", "Count", "Bytes", "Type container");
+
+    auto counts = typeArena.getTypeCounts();
+    auto bytes = typeArena.getTypeBytes();
+    MemUsage total = {0, 0};
+    for(size_t i = 0; i < counts.size(); i++){
+        fprintf(stderr, "  %10zu %12zu  %s\n", counts[i].second, bytes[i], counts[i].first);
+        total.count += counts[i].second;
+        total.bytes += bytes[i];
+    }
+    fprintf(stderr, "  %10zu %12zu  total\n", total.count, total.bytes);
+
+    vector<pair<string, MemUsage>> kinds;
+    for(auto &kind : astNodeKinds)
+        kinds.emplace_back(nodeKindName(kind.first), kind.second);
+
+    sort(kinds.begin(), kinds.end(), [](const pair<string, MemUsage> &l, const pair<string, MemUsage> &r){
+        return l.second.bytes > r.second.bytes;
+    });
+
+    fprintf(stderr, "\n  %10s %12s  %s\n", "Count", "Bytes", "Parse tree node (excluding owned strings)");
+    total = {0, 0};
+    for(auto &kind : kinds){
+        fprintf(stderr, "  %10zu %12zu  %s\n", kind.second.count, kind.second.bytes, kind.first.c_str());
+        total.count += kind.second.count;
+        total.bytes += kind.second.bytes;
+    }
+    fprintf(stderr, "  %10zu %12zu  total\n", total.count, total.bytes);
+
+    unordered_set<FuncDecl*> seen;
+    MemUsage merged = {0, 0}, compiled = {0, 0};
+    for(auto &m : allMergedCompUnits)
+        addModuleUsage(m.get(), merged, seen);
+    for(auto &m : allCompiledModules)
+        addModuleUsage(m.getValue().get(), compiled, seen);
+
+    fprintf(stderr, "\n  %10s %12s  %s\n", "Count", "Bytes", "Ante modules");
+    fprintf(stderr, "  %10zu %12zu  allMergedCompUnits\n", merged.count, merged.bytes);
+    fprintf(stderr, "  %10zu %12zu  allCompiledModules\n", compiled.count, compiled.bytes);
+    fprintf(stderr, "  %10zu %12s  distinct FuncDecls\n", seen.size(), "");
+
+    //the module is given to the JIT with -r
+    if(c->module){
+        size_t fns = 0, blocks = 0, insts = 0;
+        for(auto &f : *c->module){
+            fns++;
+            for(auto &bb : f){
+                blocks++;
+                insts += bb.size();
+            }
+        }
+
+        llvm::SmallVector<char, 0> bitcode;
+        llvm::raw_svector_ostream os{bitcode};
+        WriteBitcodeToFile(c->module.get(), os);
+
+        fprintf(stderr, "\n  llvm module %s: %zu functions, %zu globals, %zu blocks, %zu instructions, %zu bytes of bitcode\n",
+                c->module->getName().str().c_str(), fns, c->module->getGlobalList().size(), blocks, insts, bitcode.size());
+    }
+
+#ifdef unix
+    rusage usage;
+    if(!getrusage(RUSAGE_SELF, &usage))
+        fprintf(stderr, "  peak RSS: %ld KiB\n", usage.ru_maxrss);
+#endif
+    fputc('\n', stderr);
+}
+
+} //end of namespace ante
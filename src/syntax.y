@@ -49,7 +49,7 @@ void yyerror(const char *msg);
 %token I8 I16 I32 I64
 %token U8 U16 U32 U64
 %token Isz Usz F16 F32 F64
-%token C8 C32 Bool Void
+%token C8 C32 Bool Void SimdType
 
 /* operators */
 %token Eq NotEq AddEq SubEq MulEq DivEq GrtrEq LesrEq
@@ -135,7 +135,7 @@ void yyerror(const char *msg);
 
 %left '#'
 %left '@' New
-%left '&' TYPE UserType TypeVar I8 I16 I32 I64 U8 U16 U32 U64 Isz Usz F16 F32 F64 C8 C32 Bool Void
+%left '&' TYPE UserType TypeVar I8 I16 I32 I64 U8 U16 U32 U64 Isz Usz F16 F32 F64 C8 C32 Bool Void SimdType
 %nonassoc FUNC
 %left Block
 
@@ -203,7 +203,7 @@ intlit: IntLit {$$ = mkIntLitNode(@$, lextxt); free(lextxt);}
 fltlit: FltLit {$$ = mkFltLitNode(@$, lextxt); free(lextxt);}
       ;
 
-strlit: StrLit {$$ = mkStrLitNode(@$, lextxt); free(lextxt);}
+strlit: StrLit {$$ = mkStrLitNode(@$, lextxt); free(lextxt); if(!$$) YYERROR;}
       ;
 
 charlit: CharLit {$$ = mkCharLitNode(@$, lextxt); free(lextxt);}
@@ -226,6 +226,7 @@ lit_type: I8                  {$$ = mkTypeNode(@$, TT_I8,  (char*)"");}
         | C32                 {$$ = mkTypeNode(@$, TT_C32, (char*)"");}
         | Bool                {$$ = mkTypeNode(@$, TT_Bool, (char*)"");}
         | Void                {$$ = mkTypeNode(@$, TT_Void, (char*)"");}
+        | SimdType            {$$ = mkSimdTypeNode(@$, lextxt); free(lextxt);}
         | usertype  %prec LOW {$$ = mkTypeNode(@$, TT_Data, (char*)$1); free($1);}
         | typevar             {$$ = mkTypeNode(@$, TT_TypeVar, (char*)$1); free($1);}
         ;
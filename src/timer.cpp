@@ -0,0 +1,202 @@
+/*
+ *      timer.cpp
+ * Provides the scoped timers used to produce the table
+ * of time spent per phase and module printed by -time-report,
+ * and the trace events written by -trace.
+ */
+#include "timer.h"
+#include "stats.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+namespace ante {
+
+bool timeReportEnabled = false;
+
+struct PhaseTime {
+    double wall, cpu;
+    size_t count;
+};
+
+//Times of each (module, phase) pair
+map<pair<string, string>, PhaseTime> phaseTimes;
+
+//The innermost running timer
+ScopedTimer *currentTimer = nullptr;
+
+chrono::steady_clock::time_point reportWallStart;
+double reportCpuStart;
+
+double cpuTime(){
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+
+ScopedTimer::ScopedTimer(const char *phase, const string &module) :
+        phase(timeReportEnabled ? phase : nullptr), module(&module),
+        parent(nullptr), cpuStart(0), childWall(0), childCpu(0){
+
+    if(!this->phase) return;
+
+    parent = currentTimer;
+    currentTimer = this;
+    wallStart = chrono::steady_clock::now();
+    cpuStart = cpuTime();
+}
+
+
+ScopedTimer::~ScopedTimer(){
+    if(!phase) return;
+
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    double cpu = cpuTime() - cpuStart;
+
+    auto &time = phaseTimes[{*module, phase}];
+    time.wall += wall - childWall;
+    time.cpu += cpu - childCpu;
+    time.count++;
+
+    if(parent){
+        parent->childWall += wall;
+        parent->childCpu += cpu;
+    }
+    currentTimer = parent;
+}
+
+
+void enableTimeReport(){
+    if(timeReportEnabled) return;
+
+    timeReportEnabled = true;
+    reportWallStart = chrono::steady_clock::now();
+    reportCpuStart = cpuTime();
+    atexit(printTimeReport);
+}
+
+
+void printTimeReport(){
+    if(phaseTimes.empty()) return;
+
+    double totalWall = chrono::duration<double>(chrono::steady_clock::now() - reportWallStart).count();
+    double totalCpu = cpuTime() - reportCpuStart;
+
+    vector<pair<pair<string, string>, PhaseTime>> phases{phaseTimes.begin(), phaseTimes.end()};
+    map<string, PhaseTime> modules;
+
+    for(auto &p : phases){
+        auto &mod = modules[p.first.first];
+        mod.wall += p.second.wall;
+        mod.cpu += p.second.cpu;
+        mod.count += p.second.count;
+    }
+
+    auto byWall = [](const pair<string, PhaseTime> &l, const pair<string, PhaseTime> &r){
+        return l.second.wall > r.second.wall;
+    };
+
+    sort(phases.begin(), phases.end(), [](const pair<pair<string, string>, PhaseTime> &l,
+                const pair<pair<string, string>, PhaseTime> &r){
+        return l.second.wall > r.second.wall;
+    });
+
+    vector<pair<string, PhaseTime>> sortedModules{modules.begin(), modules.end()};
+    sort(sortedModules.begin(), sortedModules.end(), byWall);
+
+    fprintf(stderr, "\n===------------------------- Ante time report -------------------------===\n");
+    fprintf(stderr, "  Total: %.4fs wall, %.4fs cpu\n\n", totalWall, totalCpu);
+    fprintf(stderr, "  %10s %7s %10s %8s  %-22s %s\n", "Wall (s)", "Wall %", "CPU (s)", "Count", "Phase", "Module");
+
+    for(auto &p : phases){
+        auto &t = p.second;
+        fprintf(stderr, "  %10.4f %6.1f%% %10.4f %8zu  %-22s %s\n", t.wall,
+                totalWall > 0 ? t.wall / totalWall * 100 : 0.0, t.cpu, t.count,
+                p.first.second.c_str(), p.first.first.c_str());
+    }
+
+    fprintf(stderr, "\n  %10s %7s %10s %8s  %s\n", "Wall (s)", "Wall %", "CPU (s)", "Count", "Module");
+    for(auto &m : sortedModules){
+        auto &t = m.second;
+        fprintf(stderr, "  %10.4f %6.1f%% %10.4f %8zu  %s\n", t.wall,
+                totalWall > 0 ? t.wall / totalWall * 100 : 0.0, t.cpu, t.count, m.first.c_str());
+    }
+    fputc('\n', stderr);
+
+    phaseTimes.clear();
+}
+
+
+bool traceEnabled = false;
+string traceFile;
+vector<string> traceEvents;
+chrono::steady_clock::time_point traceStart;
+
+//Microseconds since tracing was enabled
+double traceTime(){
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - traceStart).count();
+}
+
+
+TraceEvent::TraceEvent(const char *category, const string &name) :
+        category(traceEnabled ? category : nullptr), start(0){
+
+    if(!this->category) return;
+
+    this->name = name;
+    start = traceTime();
+}
+
+
+void TraceEvent::addArg(const char *key, const string &val){
+    if(!category) return;
+
+    if(!args.empty()) args += ", ";
+    args += jsonStr(key) + ": " + jsonStr(val);
+}
+
+
+TraceEvent::~TraceEvent(){
+    if(!category) return;
+
+    double dur = traceTime() - start;
+    traceEvents.push_back("{\"name\": " + jsonStr(name) + ", \"cat\": \"" + category
+            + "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " + to_string(start)
+            + ", \"dur\": " + to_string(dur) + ", \"args\": {" + args + "}}");
+}
+
+
+void enableTrace(const string &file){
+    if(traceEnabled) return;
+
+    traceEnabled = true;
+    traceFile = file;
+    traceStart = chrono::steady_clock::now();
+    atexit(writeTrace);
+}
+
+
+void writeTrace(){
+    if(traceEvents.empty()) return;
+
+    ofstream out{traceFile};
+    if(!out){
+        cerr << "Could not open " << traceFile << " to write the trace\n";
+        return;
+    }
+
+    out << "{\"traceEvents\": [\n";
+    for(size_t i = 0; i < traceEvents.size(); i++)
+        out << traceEvents[i] << (i + 1 < traceEvents.size() ? ",\n" : "\n");
+    out << "], \"displayTimeUnit\": \"ms\"}\n";
+
+    traceEvents.clear();
+}
+
+} //end of namespace ante
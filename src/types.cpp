@@ -94,7 +94,7 @@ void validateType(Compiler *c, const AnType *tn, const DataDeclNode *rootTy){
     }else if(tn->typeTag == TT_Array){
         auto *arr = (AnArrayType*)tn;
         validateType(c, arr->extTy, rootTy);
-    }else if(tn->typeTag == TT_Ptr or tn->typeTag == TT_Function or tn->typeTag == TT_MetaFunction){
+    }else if(tn->typeTag == TT_Ptr or tn->typeTag == TT_Vector or tn->typeTag == TT_Function or tn->typeTag == TT_MetaFunction){
         return;
 
     }else if(tn->typeTag == TT_TypeVar){
@@ -166,6 +166,9 @@ size_t AnType::getSizeInBits(Compiler *c, string *incompleteType, bool force) co
     }else if(typeTag == TT_Array){
         auto *arr = (AnArrayType*)this;
         return arr->len * arr->extTy->getSizeInBits(c, incompleteType, force);
+    }else if(typeTag == TT_Vector){
+        auto *vec = (AnVectorType*)this;
+        return vec->len * vec->extTy->getSizeInBits(c, incompleteType, force);
     }else if(typeTag == TT_Ptr or typeTag == TT_Function or typeTag == TT_MetaFunction){
         return AN_USZ_SIZE;
 
@@ -601,6 +604,7 @@ TypeTag llvmTypeToTypeTag(Type *t){
     if(t->isDoubleTy()) return TT_F64;
 
     if(t->isArrayTy()) return TT_Array;
+    if(t->isVectorTy()) return TT_Vector;
     if(t->isStructTy() and !t->isEmptyTy()) return TT_Tuple; /* Could also be a TT_Data! */
     if(t->isPointerTy()) return TT_Ptr;
     if(t->isFunctionTy()) return TT_Function;
@@ -627,6 +631,10 @@ Type* Compiler::anTypeToLlvmType(const AnType *ty, bool force){
             auto *arr = (AnArrayType*)ty;
             return ArrayType::get(anTypeToLlvmType(arr->extTy, force), arr->len);
         }
+        case TT_Vector:{
+            auto *vec = (AnVectorType*)ty;
+            return VectorType::get(anTypeToLlvmType(vec->extTy, force), vec->len);
+        }
         case TT_Tuple:
             for(auto *e : ((AnAggregateType*)ty)->extTys){
                 tys.push_back(anTypeToLlvmType(e, force));
@@ -703,6 +711,9 @@ bool llvmTypeEq(Type *l, Type *r){
     }else if(ltt == TT_Array){
         return l->getArrayElementType() == r->getArrayElementType() and
                l->getArrayNumElements() == r->getArrayNumElements();
+    }else if(ltt == TT_Vector){
+        return l->getVectorElementType() == r->getVectorElementType() and
+               l->getVectorNumElements() == r->getVectorNumElements();
     }else if(ltt == TT_Function or ltt == TT_MetaFunction){
         int lParamCount = l->getFunctionNumParams();
         int rParamCount = r->getFunctionNumParams();
@@ -848,6 +859,15 @@ TypeCheckResult& typeEqBase(const AnType *l, const AnType *r, TypeCheckResult &t
         return c ? typeEqHelper(c, larr->extTy, rarr->extTy, tcr)
                  : typeEqBase(larr->extTy, rarr->extTy, tcr, c);
 
+    }else if(r->typeTag == TT_Vector){
+        auto *lvec = (AnVectorType*)l;
+        auto *rvec = (AnVectorType*)r;
+
+        if(lvec->len != rvec->len) return tcr.failure();
+
+        return c ? typeEqHelper(c, lvec->extTy, rvec->extTy, tcr)
+                 : typeEqBase(lvec->extTy, rvec->extTy, tcr, c);
+
     }else if(r->typeTag == TT_Data or r->typeTag == TT_TaggedUnion){
         auto *ldt = (AnDataType*)l;
         auto *rdt = (AnDataType*)r;
@@ -882,6 +902,9 @@ AnType* TypeCheckResult::getBindingFor(const string &name){
  *  Compiler instance required to check for trait implementation
  */
 TypeCheckResult& typeEqHelper(const Compiler *c, const AnType *l, const AnType *r, TypeCheckResult &tcr){
+    stats.typeEqHelperCalls++;
+    StatDepth depth{stats.typeEqDepth, stats.typeEqMaxDepth};
+
     if(l == r) return tcr.success();
     if(!r) return tcr.failure();
 
@@ -1023,6 +1046,7 @@ TypeCheckResult& typeEqHelper(const Compiler *c, const AnType *l, const AnType *
 }
 
 TypeCheckResult Compiler::typeEq(const AnType *l, const AnType *r) const{
+    stats.typeEqCalls++;
     auto tcr = TypeCheckResult();
     typeEqHelper(this, l, r, tcr);
     return tcr;
@@ -1030,6 +1054,7 @@ TypeCheckResult Compiler::typeEq(const AnType *l, const AnType *r) const{
 
 
 TypeCheckResult Compiler::typeEq(vector<AnType*> l, vector<AnType*> r) const{
+    stats.typeEqCalls++;
     auto tcr = TypeCheckResult();
     if(l.size() != r.size()){
         tcr.failure();
@@ -1088,6 +1113,7 @@ string typeTagToStr(TypeTag ty){
          */
         case TT_Tuple:        return "Tuple";
         case TT_Array:        return "Array";
+        case TT_Vector:       return "Vector";
         case TT_Ptr:          return "Ptr"  ;
         case TT_Data:         return "Data" ;
         case TT_TypeVar:      return "'t";
@@ -1133,6 +1159,9 @@ string typeNodeToStr(const TypeNode *t){
     }else if(t->type == TT_Array){
         auto *len = (IntLitNode*)t->extTy->next.get();
         return '[' + len->val + " " + typeNodeToStr(t->extTy.get()) + ']';
+    }else if(t->type == TT_Vector){
+        auto *len = (IntLitNode*)t->extTy->next.get();
+        return typeNodeToStr(t->extTy.get()) + 'x' + len->val;
     }else if(t->type == TT_Ptr){
         return typeNodeToStr(t->extTy.get()) + "*";
     }else if(t->type == TT_Function or t->type == TT_MetaFunction){
@@ -1195,6 +1224,8 @@ string _anTypeToStr(const AnType *t, AnModifier *m){
         return ret;
     }else if(auto *arr = dyn_cast<AnArrayType>(t)){
         return mods + '[' + to_string(arr->len) + " " + _anTypeToStr(arr->extTy, t->mods) + ']';
+    }else if(auto *vec = dyn_cast<AnVectorType>(t)){
+        return mods + _anTypeToStr(vec->extTy, t->mods) + 'x' + to_string(vec->len);
     }else if(auto *ptr = dyn_cast<AnPtrType>(t)){
         return mods + _anTypeToStr(ptr->extTy, t->mods) + "*";
     }else{
@@ -1238,6 +1269,8 @@ string llvmTypeToStr(Type *ty){
         return ret;
     }else if(tt == TT_Array){
         return "[" + to_string(ty->getArrayNumElements()) + " " + llvmTypeToStr(ty->getArrayElementType()) + "]";
+    }else if(tt == TT_Vector){
+        return llvmTypeToStr(ty->getVectorElementType()) + "x" + to_string(ty->getVectorNumElements());
     }else if(tt == TT_Ptr){
         return llvmTypeToStr(ty->getPointerElementType()) + "*";
     }else if(tt == TT_Function){